@@ -31,6 +31,8 @@ CREATE TABLE IF NOT EXISTS trips (
     route_id INTEGER NOT NULL,
     start_time TEXT NOT NULL, -- HH:MM:SS
     end_time TEXT NOT NULL,   -- HH:MM:SS
+    start_seconds INTEGER,    -- segundos desde la medianoche del día de servicio (puede pasar de 24:00)
+    end_seconds INTEGER,
     created_at DATETIME DEFAULT CURRENT_TIMESTAMP,
     FOREIGN KEY (route_id) REFERENCES routes(id) ON DELETE CASCADE
 );
@@ -40,6 +42,7 @@ CREATE TABLE IF NOT EXISTS trip_stops (
     trip_id INTEGER,
     stop_id INTEGER,
     arrival_time TEXT NOT NULL, -- HH:MM:SS
+    arrival_seconds INTEGER,    -- NULL si la parada no tiene hora
     sequence INTEGER NOT NULL,
     PRIMARY KEY (trip_id, stop_id),
     FOREIGN KEY (trip_id) REFERENCES trips(id) ON DELETE CASCADE,
@@ -52,4 +55,7 @@ CREATE INDEX IF NOT EXISTS idx_route_stops_route ON route_stops(route_id);
 CREATE INDEX IF NOT EXISTS idx_route_stops_stop ON route_stops(stop_id);
 CREATE INDEX IF NOT EXISTS idx_trips_route ON trips(route_id);
 CREATE INDEX IF NOT EXISTS idx_trip_stops_trip ON trip_stops(trip_id);
-CREATE INDEX IF NOT EXISTS idx_trip_stops_stop ON trip_stops(stop_id);
\ No newline at end of file
+CREATE INDEX IF NOT EXISTS idx_trip_stops_stop ON trip_stops(stop_id);
+-- Índices de cobertura para consultas por franja horaria
+CREATE INDEX IF NOT EXISTS idx_trips_service_time ON trips(start_seconds, end_seconds, id);
+CREATE INDEX IF NOT EXISTS idx_trip_stops_stop_time ON trip_stops(stop_id, arrival_seconds, trip_id);
\ No newline at end of file
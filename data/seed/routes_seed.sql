@@ -40,8 +40,8 @@ INSERT INTO route_stops (route_id, stop_id, sequence) VALUES
 (4, 10, 2);  -- Aeropuerto (directo)
 
 -- Viajes de ejemplo
-INSERT INTO trips (id, route_id, start_time, end_time) VALUES
-(1, 1, '06:00:00', '06:45:00'),
-(2, 1, '07:00:00', '07:45:00'),
-(3, 2, '06:30:00', '07:30:00'),
-(4, 5, '05:45:00', '06:15:00');
\ No newline at end of file
+INSERT INTO trips (id, route_id, start_time, end_time, start_seconds, end_seconds) VALUES
+(1, 1, '06:00:00', '06:45:00', 21600, 24300),
+(2, 1, '07:00:00', '07:45:00', 25200, 27900),
+(3, 2, '06:30:00', '07:30:00', 23400, 27000),
+(4, 5, '05:45:00', '06:15:00', 20700, 22500);
\ No newline at end of file
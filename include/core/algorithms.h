@@ -2,11 +2,24 @@
 #define ALGORITHMS_H
 
 #include "graph.h"
+#include "csr_graph.h"
+#include "search_workspace.h"
+#include "landmarks.h"
+#include "timetable.h"
+#include "connection_table.h"
+#include "stop_route_index.h"
+#include "thread_pool.h"
 #include <vector>
 #include <unordered_map>
 
 namespace urban_transport {
 
+// Parada alcanzada por una isócrona con su coste desde el origen
+struct ReachableStop {
+    int stop_id;
+    double cost;
+};
+
 class TransportAlgorithms {
 public:
     // Dijkstra para camino más corto
@@ -14,6 +27,133 @@ public:
         const Graph& graph, 
         int start_node, 
         int end_node);
+
+    // Dijkstra sobre la instantánea CSR (ids de parada en entrada y salida).
+    // Sin workspace explícito se usa el del hilo actual.
+    static std::vector<int> dijkstra_shortest_path(
+        const CsrGraph& graph,
+        int start_node,
+        int end_node);
+    static std::vector<int> dijkstra_shortest_path(
+        const CsrGraph& graph,
+        int start_node,
+        int end_node,
+        SearchWorkspace& workspace);
+    
+    // A* con la distancia Haversine al destino como heurística admisible.
+    // Requiere que los pesos sean distancias geográficas en km; los nodos
+    // sin coordenadas usan heurística 0 (equivale a Dijkstra).
+    static std::vector<int> astar_shortest_path(
+        const CsrGraph& graph,
+        int start_node,
+        int end_node);
+    static std::vector<int> astar_shortest_path(
+        const CsrGraph& graph,
+        int start_node,
+        int end_node,
+        SearchWorkspace& workspace);
+    
+    // ALT: A* con cotas de landmarks por desigualdad triangular. Las cotas
+    // siguen siendo válidas si los pesos solo aumentan desde el preprocesado.
+    static std::vector<int> alt_shortest_path(
+        const CsrGraph& graph,
+        const LandmarkIndex& landmarks,
+        int start_node,
+        int end_node);
+    static std::vector<int> alt_shortest_path(
+        const CsrGraph& graph,
+        const LandmarkIndex& landmarks,
+        int start_node,
+        int end_node,
+        SearchWorkspace& workspace);
+
+    // Dijkstra bidireccional sobre el CSR directo e inverso. Se detiene cuando
+    // la suma de los mínimos de ambas colas alcanza el mejor camino conocido.
+    static std::vector<int> bidirectional_dijkstra(
+        const CsrGraph& graph,
+        int start_node,
+        int end_node);
+    static std::vector<int> bidirectional_dijkstra(
+        const CsrGraph& graph,
+        int start_node,
+        int end_node,
+        BidirectionalWorkspace& workspace);
+    
+    // Matriz de distancias origen x destino en orden por filas
+    // (fila = origen). Una búsqueda uno-a-muchos por origen que termina al
+    // asentar todos los destinos; los orígenes se reparten en el pool.
+    // Infinito si no hay camino o el id no existe.
+    static std::vector<double> distance_matrix(
+        const CsrGraph& graph,
+        const std::vector<int>& sources,
+        const std::vector<int>& targets,
+        ThreadPool& pool);
+    
+    // Isócrona: paradas alcanzables desde start_node con coste <= budget (en
+    // las unidades del peso de las aristas), en orden creciente de coste e
+    // incluido el origen. La versión con workspace y salida del llamante no
+    // reserva memoria una vez que los buffers han crecido.
+    static std::vector<ReachableStop> isochrone(
+        const CsrGraph& graph,
+        int start_node,
+        double budget);
+    static void isochrone(
+        const CsrGraph& graph,
+        int start_node,
+        double budget,
+        SearchWorkspace& workspace,
+        std::vector<ReachableStop>& reached);
+
+    // Varios presupuestos crecientes (p. ej. 5/10/15/30) en una sola búsqueda.
+    // Las bandas son anillos disjuntos: la banda b ocupa
+    // reached[band_offsets[b], band_offsets[b + 1]) y contiene las paradas con
+    // budgets[b-1] < coste <= budgets[b]. budgets debe estar ordenado.
+    static void isochrone_bands(
+        const CsrGraph& graph,
+        int start_node,
+        const std::vector<double>& budgets,
+        SearchWorkspace& workspace,
+        std::vector<ReachableStop>& reached,
+        std::vector<size_t>& band_offsets);
+
+    // Área de captación de todas las paradas: fila por nodo (orden de índice
+    // denso del CSR) con el número de paradas alcanzables dentro de cada
+    // presupuesto. Los orígenes se reparten en el pool.
+    static std::vector<size_t> catchment_counts(
+        const CsrGraph& graph,
+        const std::vector<double>& budgets,
+        ThreadPool& pool);
+
+    // RAPTOR: llegada más temprana a end_stop saliendo de start_stop a partir
+    // de departure_time (segundos de servicio), con como mucho max_transfers
+    // transbordos. Cada ronda recorre una vez los recorridos que pasan por las
+    // paradas mejoradas en la ronda anterior. Los transbordos son en la
+    // misma parada. Entre itinerarios igual de rápidos prefiere menos viajes.
+    static Journey raptor_earliest_arrival(
+        const Timetable& timetable,
+        int start_stop,
+        int end_stop,
+        int departure_time,
+        int max_transfers);
+    
+    // Connection Scan: llegada más temprana con una sola pasada lineal por
+    // las conexiones que salen a partir de departure_time. Sin límite de
+    // transbordos; termina al superar la mejor llegada al destino.
+    static Journey csa_earliest_arrival(
+        const ConnectionTable& connections,
+        int start_stop,
+        int end_stop,
+        int departure_time);
+
+    // Perfil CSA: todas las salidas Pareto-óptimas de start_stop a end_stop
+    // con salida en [window_start, window_end], ordenadas por hora de salida.
+    // Una pasada en orden inverso de salida sustituye a una consulta por hora.
+    static std::vector<ProfileEntry> csa_profile(
+        const ConnectionTable& connections,
+        int start_stop,
+        int end_stop,
+        int window_start,
+        int window_end);
     
     // BFS para exploración
     static std::vector<int> bfs_reachable_nodes(
@@ -21,10 +161,15 @@ public:
         int start_node, 
         int max_depth);
     
-    // Algoritmo para rutas que pasan por una parada
+    // Rutas que pasan por una parada, ordenadas y sin repetir. La variante
+    // con el mapa construye el índice en cada llamada: para consultas
+    // repetidas conviene construir el StopRouteIndex una vez.
     static std::vector<int> find_routes_through_stop(
         const std::unordered_map<int, std::vector<int>>& route_stops,
         int stop_id);
+    static std::vector<int> find_routes_through_stop(
+        const StopRouteIndex& index,
+        int stop_id);
     
     // Cálculo de distancia entre coordenadas (Haversine)
     static double calculate_distance(
@@ -0,0 +1,56 @@
+#ifndef CONNECTION_TABLE_H
+#define CONNECTION_TABLE_H
+
+#include "timetable.h"
+#include <vector>
+#include <cstddef>
+
+namespace urban_transport {
+
+// Conexión elemental: un vehículo va de departure_stop a arrival_stop sin
+// paradas intermedias. Paradas y viajes son índices densos de la tabla.
+struct Connection {
+    int departure_stop;
+    int arrival_stop;
+    int departure_time;
+    int arrival_time;
+    int trip;
+};
+
+// Salida Pareto-óptima de un perfil: no hay otra que salga más tarde y
+// llegue igual de pronto
+struct ProfileEntry {
+    int departure_time;
+    int arrival_time;
+};
+
+// Todas las conexiones del horario en un único array ordenado por hora de
+// salida (y de llegada en caso de empate), para el Connection Scan Algorithm.
+class ConnectionTable {
+public:
+    ConnectionTable() = default;
+    explicit ConnectionTable(const std::vector<ScheduledTrip>& trips);
+
+    bool empty() const { return connections_.empty(); }
+    size_t stop_count() const { return stop_ids_.size(); }
+    size_t trip_count() const { return trip_ids_.size(); }
+    size_t connection_count() const { return connections_.size(); }
+
+    // Conversión id de parada <-> índice denso (-1 si el id no existe)
+    int index_of(int stop_id) const;
+    int stop_id(int index) const { return stop_ids_[index]; }
+    int trip_id(int trip) const { return trip_ids_[trip]; }
+
+    const Connection& connection(size_t index) const { return connections_[index]; }
+    // Primera conexión que sale a partir de time
+    size_t first_departure(int time) const;
+
+private:
+    std::vector<int> stop_ids_;
+    std::vector<int> trip_ids_;
+    std::vector<Connection> connections_;
+};
+
+} // namespace urban_transport
+
+#endif // CONNECTION_TABLE_H
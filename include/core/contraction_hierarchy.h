@@ -0,0 +1,64 @@
+#ifndef CONTRACTION_HIERARCHY_H
+#define CONTRACTION_HIERARCHY_H
+
+#include "csr_graph.h"
+#include "search_workspace.h"
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace urban_transport {
+
+// Jerarquía de contracción construida a partir de una instantánea CSR.
+// Cada arco conserva el nodo intermedio del atajo (-1 si es una arista
+// original) para poder desempaquetar el camino en la secuencia de paradas.
+class ContractionHierarchy {
+public:
+    ContractionHierarchy() = default;
+
+    // Preprocesa el grafo contrayendo conjuntos independientes de nodos en
+    // paralelo; thread_count = 0 usa todos los núcleos disponibles.
+    explicit ContractionHierarchy(const CsrGraph& graph, size_t thread_count = 0);
+
+    bool empty() const { return node_ids_.empty(); }
+    size_t node_count() const { return node_ids_.size(); }
+    size_t arc_count() const { return up_targets_.size() + down_targets_.size(); }
+    size_t shortcut_count() const { return shortcut_count_; }
+
+    // Camino más corto en ids de parada (vacío si no existe)
+    std::vector<int> shortest_path(int start_node, int end_node) const;
+    std::vector<int> shortest_path(int start_node, int end_node,
+                                   BidirectionalWorkspace& workspace) const;
+
+    // Formato binario propio (cabecera con versión); false si falla la E/S
+    // o el archivo no es válido
+    bool save(const std::string& filename) const;
+    bool load(const std::string& filename);
+
+private:
+    std::vector<int> node_ids_;
+    std::vector<int> rank_;
+    size_t shortcut_count_ = 0;
+
+    // Arcos hacia nodos de mayor rango, agrupados por nodo de origen
+    std::vector<uint32_t> up_offsets_;
+    std::vector<int> up_targets_;
+    std::vector<double> up_weights_;
+    std::vector<int> up_middles_;
+
+    // Arcos x -> v con rango(x) > rango(v), agrupados por v (target = x)
+    std::vector<uint32_t> down_offsets_;
+    std::vector<int> down_targets_;
+    std::vector<double> down_weights_;
+    std::vector<int> down_middles_;
+
+    int index_of(int node_id) const;
+    int up_middle(int from, int to) const;
+    int down_middle(int from, int to) const;
+    void unpack(int from, int to, int middle, std::vector<int>& path) const;
+};
+
+} // namespace urban_transport
+
+#endif // CONTRACTION_HIERARCHY_H
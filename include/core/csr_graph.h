@@ -0,0 +1,67 @@
+#ifndef CSR_GRAPH_H
+#define CSR_GRAPH_H
+
+#include "graph.h"
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace urban_transport {
+
+// Instantánea inmutable del grafo en formato CSR (compressed sparse row).
+// Los nodos se renumeran con índices densos [0, node_count) en orden creciente
+// de id de parada; las aristas de cada nodo son contiguas en memoria.
+// Los arrays pueden ser propios o una vista sobre memoria externa (p. ej.
+// una instantánea mapeada); copiar un CsrGraph comparte los datos.
+class CsrGraph {
+public:
+    CsrGraph() = default;
+    explicit CsrGraph(const Graph& graph);
+
+    size_t node_count() const { return node_count_; }
+    size_t edge_count() const { return edge_count_; }
+
+    // Conversión id de parada <-> índice denso (-1 si el id no existe)
+    int index_of(int node_id) const;
+    int node_id(int index) const { return node_ids_[index]; }
+    bool has_node(int node_id) const { return index_of(node_id) >= 0; }
+
+    // Rango [edge_begin, edge_end) de aristas salientes de un índice
+    uint32_t edge_begin(int index) const { return offsets_[index]; }
+    uint32_t edge_end(int index) const { return offsets_[index + 1]; }
+    int edge_target(uint32_t edge) const { return targets_[edge]; }
+    double edge_weight(uint32_t edge) const { return weights_[edge]; }
+
+    // Aristas entrantes (CSR inverso): in_edge_source es el índice de origen
+    uint32_t in_edge_begin(int index) const { return in_offsets_[index]; }
+    uint32_t in_edge_end(int index) const { return in_offsets_[index + 1]; }
+    int in_edge_source(uint32_t edge) const { return in_sources_[edge]; }
+    double in_edge_weight(uint32_t edge) const { return in_weights_[edge]; }
+
+    // Coordenadas por índice denso (NaN si el nodo no las tiene)
+    bool has_coordinates(int index) const;
+    double latitude(int index) const { return latitudes_[index]; }
+    double longitude(int index) const { return longitudes_[index]; }
+
+private:
+    // Mantiene viva la memoria a la que apuntan los arrays
+    std::shared_ptr<const void> owner_;
+    size_t node_count_ = 0;
+    size_t edge_count_ = 0;
+    const int* node_ids_ = nullptr;
+    const uint32_t* offsets_ = nullptr;
+    const int* targets_ = nullptr;
+    const double* weights_ = nullptr;
+    const uint32_t* in_offsets_ = nullptr;
+    const int* in_sources_ = nullptr;
+    const double* in_weights_ = nullptr;
+    const double* latitudes_ = nullptr;
+    const double* longitudes_ = nullptr;
+
+    friend class NetworkSnapshot;
+};
+
+} // namespace urban_transport
+
+#endif // CSR_GRAPH_H
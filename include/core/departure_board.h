@@ -0,0 +1,72 @@
+#ifndef DEPARTURE_BOARD_H
+#define DEPARTURE_BOARD_H
+
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+
+namespace urban_transport {
+
+// Paso de un viaje por una parada. time son segundos del día de servicio del
+// viaje: una salida de la madrugada puede venir como 24:xx del día anterior.
+struct Departure {
+    int time;
+    int trip_id;
+    int route_id;
+
+    bool operator==(const Departure& other) const {
+        return time == other.time && trip_id == other.trip_id && route_id == other.route_id;
+    }
+};
+
+struct RouteDepartures {
+    int route_id;
+    std::vector<Departure> departures;
+};
+
+// Panel de próximas salidas: por cada parada, las horas de paso ordenadas en
+// un array de enteros con los viajes y rutas en arrays paralelos. Una
+// consulta es un hash de la parada, una búsqueda binaria y un recorrido
+// acotado por el número de resultados o la ventana. Admite altas y bajas
+// incrementales (O(salidas de la parada)).
+class DepartureBoard {
+public:
+    DepartureBoard() = default;
+
+    size_t stop_count() const { return stops_.size(); }
+    size_t departure_count() const { return departure_count_; }
+
+    // Alta de un paso; si el viaje ya pasaba por la parada se sustituye
+    void add(int stop_id, int time, int trip_id, int route_id);
+    // Quita todos los pasos del viaje
+    void remove_trip(int trip_id);
+    void set_trip_route(int trip_id, int route_id);
+
+    // Las count primeras salidas desde time (incluida). Antes de las 24:00
+    // incluyen las del día de servicio anterior (24:xx) en su orden real.
+    std::vector<Departure> next_departures(int stop_id, int time, size_t count) const;
+    // Salidas en [time, time + window] agrupadas por ruta, como mucho
+    // per_route por ruta; las rutas en orden de su primera salida
+    std::vector<RouteDepartures> next_departures_by_route(int stop_id, int time, int window,
+                                                          size_t per_route) const;
+
+private:
+    struct StopDepartures {
+        std::vector<int> times; // ordenadas
+        std::vector<int> trip_ids;
+        std::vector<int> route_ids;
+    };
+    std::unordered_map<int, StopDepartures> stops_;
+    std::unordered_map<int, std::vector<int>> trip_stops_; // viaje -> paradas, para las bajas
+    size_t departure_count_ = 0;
+
+    bool erase(StopDepartures& stop, int trip_id);
+    // Salidas de la parada con hora en [from, until], en orden, real o del
+    // día anterior según la hora; visit devuelve false para parar
+    template <typename Visit>
+    void scan(int stop_id, int from, int until, Visit visit) const;
+};
+
+} // namespace urban_transport
+
+#endif // DEPARTURE_BOARD_H
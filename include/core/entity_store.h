@@ -0,0 +1,214 @@
+#ifndef ENTITY_STORE_H
+#define ENTITY_STORE_H
+
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <optional>
+#include <shared_mutex>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace urban_transport {
+
+struct EntityStoreStats {
+    size_t hits = 0;         // lecturas servidas desde memoria
+    size_t misses = 0;       // lecturas que tuvieron que cargar la tabla
+    size_t entries = 0;
+    size_t memory_bytes = 0; // estimación: entidades, cadenas, vectores e índice
+    uint64_t version = 0;    // cambia con cada carga o modificación
+    bool loaded = false;
+};
+
+// Copia en memoria de una tabla de entidades con campo int id, cargada
+// entera en el primer acceso con el loader y mantenida después por los
+// escritores (upsert/replace/update/erase). Las entidades se guardan
+// ordenadas por id con un índice id -> posición: find es O(1) y all() no
+// toca la base de datos. Mientras no se ha cargado, las modificaciones se
+// ignoran porque la primera lectura verá la tabla completa. Los cambios
+// hechos por otras conexiones no se detectan: invalidate() fuerza la recarga.
+// Necesita una función entity_heap_bytes(const Entity&) visible por ADL.
+template <typename Entity>
+class EntityStore {
+public:
+    using Loader = std::function<std::vector<Entity>()>;
+
+    explicit EntityStore(Loader loader = Loader()) : loader_(std::move(loader)) {}
+
+    void set_loader(Loader loader) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        loader_ = std::move(loader);
+        clear();
+    }
+
+    std::optional<Entity> find(int id) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        lock_loaded(lock);
+        auto it = positions_.find(id);
+        if (it == positions_.end()) return std::nullopt;
+        return entities_[it->second];
+    }
+
+    // Todas las entidades ordenadas por id
+    std::vector<Entity> all() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        lock_loaded(lock);
+        return entities_;
+    }
+
+    // Entidades que cumplen el predicado, ordenadas por id
+    template <typename Predicate>
+    std::vector<Entity> filter(Predicate predicate) const {
+        std::vector<Entity> result;
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        lock_loaded(lock);
+        for (const auto& entity : entities_) {
+            if (predicate(entity)) result.push_back(entity);
+        }
+        return result;
+    }
+
+    // Alta o sustitución
+    void upsert(const Entity& entity) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        if (!loaded_) return;
+        auto it = positions_.find(entity.id);
+        if (it != positions_.end()) {
+            assign(it->second, entity);
+        } else {
+            insert(entity);
+        }
+        ++version_;
+    }
+
+    // Sustituye solo si ya existe (un UPDATE sin filas no da de alta)
+    void replace(const Entity& entity) {
+        update(entity.id, [&](Entity& cached) { cached = entity; });
+    }
+
+    // Modifica en sitio la entidad cacheada, si existe
+    void update(int id, const std::function<void(Entity&)>& change) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        if (!loaded_) return;
+        auto it = positions_.find(id);
+        if (it == positions_.end()) return;
+        Entity entity = entities_[it->second];
+        change(entity);
+        assign(it->second, entity);
+        ++version_;
+    }
+
+    void erase(int id) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        if (!loaded_) return;
+        auto it = positions_.find(id);
+        if (it == positions_.end()) return;
+        size_t position = it->second;
+        memory_ -= entity_heap_bytes(entities_[position]);
+        entities_.erase(entities_.begin() + position);
+        positions_.erase(it);
+        reindex_from(position);
+        ++version_;
+    }
+
+    // Descarta el contenido; la siguiente lectura recarga la tabla
+    void invalidate() {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        clear();
+    }
+
+    EntityStoreStats stats() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        EntityStoreStats stats;
+        stats.hits = hits_.load(std::memory_order_relaxed);
+        stats.misses = misses_.load(std::memory_order_relaxed);
+        stats.entries = entities_.size();
+        stats.memory_bytes = memory_ + entities_.capacity() * sizeof(Entity) +
+                             positions_.size() * (sizeof(std::pair<const int, size_t>) + 2 * sizeof(void*)) +
+                             positions_.bucket_count() * sizeof(void*);
+        stats.version = version_;
+        stats.loaded = loaded_;
+        return stats;
+    }
+
+private:
+    Loader loader_;
+    mutable std::shared_mutex mutex_;
+    mutable bool loaded_ = false;
+    mutable std::vector<Entity> entities_;                // ordenadas por id
+    mutable std::unordered_map<int, size_t> positions_;   // id -> posición
+    mutable size_t memory_ = 0;                           // memoria dinámica de las entidades
+    mutable uint64_t version_ = 0;
+    mutable std::atomic<size_t> hits_{0};
+    mutable std::atomic<size_t> misses_{0};
+
+    // Deja tomado el lock de lectura con la tabla cargada, cargándola antes
+    // si hace falta. Cuenta un acierto o un fallo por lectura.
+    void lock_loaded(std::shared_lock<std::shared_mutex>& lock) const {
+        if (loaded_) {
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        while (!loaded_) {
+            lock.unlock();
+            load();
+            lock.lock();
+        }
+    }
+
+    // Carga completa; otro hilo puede haberse adelantado
+    void load() const {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        if (loaded_) return;
+        std::vector<Entity> entities = loader_ ? loader_() : std::vector<Entity>();
+        std::sort(entities.begin(), entities.end(),
+                  [](const Entity& a, const Entity& b) { return a.id < b.id; });
+        entities_ = std::move(entities);
+        positions_.clear();
+        positions_.reserve(entities_.size());
+        memory_ = 0;
+        for (size_t i = 0; i < entities_.size(); ++i) {
+            positions_[entities_[i].id] = i;
+            memory_ += entity_heap_bytes(entities_[i]);
+        }
+        loaded_ = true;
+        ++version_;
+    }
+
+    void clear() {
+        entities_.clear();
+        entities_.shrink_to_fit();
+        positions_.clear();
+        memory_ = 0;
+        loaded_ = false;
+        ++version_;
+    }
+
+    void assign(size_t position, const Entity& entity) {
+        memory_ -= entity_heap_bytes(entities_[position]);
+        entities_[position] = entity;
+        memory_ += entity_heap_bytes(entity);
+    }
+
+    // Las altas suelen llevar el id mayor: entonces basta con añadir al final
+    void insert(const Entity& entity) {
+        auto it = std::lower_bound(entities_.begin(), entities_.end(), entity.id,
+                                   [](const Entity& a, int id) { return a.id < id; });
+        size_t position = static_cast<size_t>(it - entities_.begin());
+        entities_.insert(it, entity);
+        memory_ += entity_heap_bytes(entity);
+        reindex_from(position);
+    }
+
+    void reindex_from(size_t position) {
+        for (size_t i = position; i < entities_.size(); ++i) positions_[entities_[i].id] = i;
+    }
+};
+
+} // namespace urban_transport
+
+#endif // ENTITY_STORE_H
@@ -0,0 +1,71 @@
+#ifndef GEO_DISTANCE_H
+#define GEO_DISTANCE_H
+
+#include <vector>
+#include <cstddef>
+
+namespace urban_transport {
+
+// Coordenadas en estructura de arrays, ya en radianes y con los senos y
+// cosenos que necesitan los núcleos por lotes. Los semiángulos permiten
+// obtener sin(Δ/2) como una resta de productos sin llamar a sin().
+class CoordinateBlock {
+public:
+    CoordinateBlock() = default;
+
+    size_t size() const { return latitudes_.size(); }
+    bool empty() const { return latitudes_.empty(); }
+    void reserve(size_t count);
+    void clear();
+
+    // Añade un punto en grados
+    void push_back(double latitude, double longitude);
+    // Quita el punto index moviendo el último a su lugar (O(1), no estable)
+    void swap_remove(size_t index);
+
+    const double* latitudes() const { return latitudes_.data(); }   // rad
+    const double* longitudes() const { return longitudes_.data(); } // rad
+    const double* cos_latitudes() const { return cos_latitudes_.data(); }
+    const double* sin_half_latitudes() const { return sin_half_latitudes_.data(); }
+    const double* cos_half_latitudes() const { return cos_half_latitudes_.data(); }
+    const double* sin_half_longitudes() const { return sin_half_longitudes_.data(); }
+    const double* cos_half_longitudes() const { return cos_half_longitudes_.data(); }
+
+private:
+    std::vector<double> latitudes_;
+    std::vector<double> longitudes_;
+    std::vector<double> cos_latitudes_;
+    std::vector<double> sin_half_latitudes_;
+    std::vector<double> cos_half_latitudes_;
+    std::vector<double> sin_half_longitudes_;
+    std::vector<double> cos_half_longitudes_;
+};
+
+// Núcleo usado por haversine_batch; AUTO elige el mejor que soporte la CPU
+enum class DistanceKernel {
+    AUTO,
+    SCALAR,
+    SSE2,
+    AVX2
+};
+
+// Mejor núcleo disponible en la CPU actual
+DistanceKernel best_distance_kernel();
+
+// Distancias Haversine (km) desde (latitude, longitude) en grados hasta cada
+// punto del bloque; out debe tener block.size() elementos. Los núcleos SIMD
+// evalúan asin con una serie de Taylor para distancias de hasta ~1270 km y
+// recurren a std::asin en los carriles más lejanos. Si se pide un núcleo que
+// la CPU no soporta se usa el mejor disponible.
+void haversine_batch(double latitude, double longitude, const CoordinateBlock& block,
+                     double* out, DistanceKernel kernel = DistanceKernel::AUTO);
+
+// Aproximación equirectangular con la latitud media, sin funciones
+// trascendentes. Para distancias menores de 20 km y |latitud| < 70° el error
+// relativo frente a Haversine es inferior a 1e-5 (un centímetro por km).
+void equirectangular_batch(double latitude, double longitude, const CoordinateBlock& block,
+                           double* out);
+
+} // namespace urban_transport
+
+#endif // GEO_DISTANCE_H
@@ -4,6 +4,7 @@
 #include <vector>
 #include <unordered_map>
 #include <utility>
+#include <cstddef>
 
 namespace urban_transport {
 
@@ -21,8 +22,16 @@ public:
     void add_node(int node_id);
     void add_edge(int from, int to, double weight);
     void remove_edge(int from, int to);
+    // Cambia el peso de la arista from -> to; false si no existe
+    bool set_edge_weight(int from, int to, double weight);
+
+    // Coordenadas geográficas del nodo (grados), usadas por las heurísticas
+    void set_coordinates(int node_id, double latitude, double longitude);
+    bool get_coordinates(int node_id, double& latitude, double& longitude) const;
     
     const std::vector<Edge>& get_edges(int node_id) const;
+    // Aristas entrantes: Edge::target es el nodo de origen
+    const std::vector<Edge>& get_incoming_edges(int node_id) const;
     bool has_node(int node_id) const;
     size_t node_count() const;
     
@@ -30,6 +39,8 @@ public:
 
 private:
     std::unordered_map<int, std::vector<Edge>> adjacency_list;
+    std::unordered_map<int, std::vector<Edge>> reverse_adjacency_list;
+    std::unordered_map<int, std::pair<double, double>> coordinates;
 };
 
 } // namespace urban_transport
@@ -0,0 +1,46 @@
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+#include "csr_graph.h"
+#include <vector>
+#include <cstddef>
+
+namespace urban_transport {
+
+// Estrategia de selección de landmarks
+enum class LandmarkSelection {
+    FARTHEST, // cada landmark es el nodo más lejano a los ya elegidos
+    AVOID     // heurística "avoid": evita regiones ya bien cubiertas
+};
+
+// Distancias precalculadas desde y hacia un conjunto de landmarks (ALT).
+// Las tablas se guardan por nodo ([nodo * landmark_count + l]) para que la
+// cota de un nodo lea una sola línea contigua.
+class LandmarkIndex {
+public:
+    LandmarkIndex() = default;
+    LandmarkIndex(const CsrGraph& graph, size_t landmark_count,
+                  LandmarkSelection selection = LandmarkSelection::AVOID,
+                  size_t thread_count = 0);
+
+    bool empty() const { return landmarks_.empty(); }
+    size_t node_count() const { return node_count_; }
+    size_t landmark_count() const { return landmarks_.size(); }
+    // Índices densos de los landmarks elegidos
+    const std::vector<int>& landmarks() const { return landmarks_; }
+
+    // Cota inferior de d(from, to) por desigualdad triangular (índices densos).
+    // Devuelve infinito si los landmarks prueban que to es inalcanzable.
+    // Sigue siendo válida si los pesos del grafo solo aumentan.
+    double lower_bound(int from, int to) const;
+
+private:
+    size_t node_count_ = 0;
+    std::vector<int> landmarks_;
+    std::vector<double> from_landmark_; // d(L, nodo)
+    std::vector<double> to_landmark_;   // d(nodo, L)
+};
+
+} // namespace urban_transport
+
+#endif // LANDMARKS_H
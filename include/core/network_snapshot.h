@@ -0,0 +1,72 @@
+#ifndef NETWORK_SNAPSHOT_H
+#define NETWORK_SNAPSHOT_H
+
+#include "csr_graph.h"
+#include "stop_route_index.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace urban_transport {
+
+// Ruta tal como se guarda en la instantánea
+struct SnapshotRoute {
+    int id;
+    std::string name;
+    std::string transport_type;
+    std::vector<int> stop_ids;
+};
+
+// Huella de la base de datos SQLite sin abrirla con SQLite: contador de
+// cambios y número de páginas de la cabecera, más tamaño y fecha de
+// modificación del fichero y de su -wal. Cualquier escritura confirmada la
+// cambia. 0 si el fichero no existe o no es una base SQLite.
+uint64_t database_fingerprint(const std::string& db_path);
+
+// Instantánea binaria de la red: grafo CSR con coordenadas, índice
+// parada -> rutas y nombres de rutas internados. Cada sección está alineada
+// a 8 bytes, así que al abrirla con mmap el grafo se usa en su sitio, sin
+// copiar ni reconstruir (sin mmap, en Windows, se lee entera a memoria). El formato es el nativo de la máquina; una
+// instantánea de otra arquitectura se rechaza por el número mágico.
+class NetworkSnapshot {
+public:
+    NetworkSnapshot() = default;
+
+    // Escribe en un temporal propio del escritor y lo renombra, de modo que
+    // un lector nunca ve un fichero a medias y dos escritores no se pisan.
+    // adjusted_weights marca un grafo con pesos cambiados en memoria, que ya
+    // no es el que describe la base de datos de esa huella.
+    static bool write(const std::string& path, uint64_t fingerprint, const CsrGraph& graph,
+                      const std::vector<SnapshotRoute>& routes, bool adjusted_weights = false);
+
+    // Mapea el fichero en solo lectura (o lo lee, sin mmap). false si no
+    // existe, está truncado o corrupto (suma de control) o su huella no es
+    // expected_fingerprint.
+    bool open(const std::string& path, uint64_t expected_fingerprint);
+
+    bool is_open() const { return data_ != nullptr; }
+
+    // Vista sobre la memoria mapeada; mantiene el mapeo vivo aunque la
+    // instantánea se destruya
+    const CsrGraph& graph() const { return graph_; }
+
+    bool adjusted_weights() const { return adjusted_weights_; }
+    size_t route_count() const { return route_count_; }
+    // Rutas en orden de id, con sus paradas
+    std::vector<SnapshotRoute> routes() const;
+    // Copia el índice parada -> rutas guardado, sin recalcularlo
+    StopRouteIndex route_index() const;
+
+private:
+    std::shared_ptr<const void> mapping_;
+    const char* data_ = nullptr;
+    size_t route_count_ = 0;
+    bool adjusted_weights_ = false;
+    CsrGraph graph_;
+};
+
+} // namespace urban_transport
+
+#endif // NETWORK_SNAPSHOT_H
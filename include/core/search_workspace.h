@@ -0,0 +1,62 @@
+#ifndef SEARCH_WORKSPACE_H
+#define SEARCH_WORKSPACE_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace urban_transport {
+
+// Estado reutilizable de una búsqueda tipo Dijkstra sobre índices densos.
+// Las distancias y padres se invalidan en O(1) incrementando una época: una
+// entrada solo es válida si su sello coincide con la época actual. Así una
+// consulta que toca pocos nodos no paga por limpiar todo el grafo.
+class SearchWorkspace {
+public:
+    struct HeapEntry {
+        double key;
+        int node;
+    };
+
+    SearchWorkspace() = default;
+
+    // Prepara una nueva búsqueda sobre un grafo de node_count nodos
+    void reset(size_t node_count);
+
+    double distance(int node) const;
+    int parent(int node) const { return reached(node) ? parents_[node] : -1; }
+    bool reached(int node) const { return stamps_[node] == epoch_; }
+    bool settled(int node) const { return settled_stamps_[node] == epoch_; }
+
+    void set_distance(int node, double distance, int parent);
+    void settle(int node) { settled_stamps_[node] = epoch_; }
+
+    // Montículo binario con borrado perezoso (se admiten entradas obsoletas)
+    void push(double key, int node);
+    HeapEntry pop();
+    const HeapEntry& top() const { return heap_.front(); }
+    bool heap_empty() const { return heap_.empty(); }
+
+    // Instancia propia del hilo que llama, reutilizada entre consultas
+    static SearchWorkspace& for_current_thread();
+
+private:
+    uint32_t epoch_ = 0;
+    std::vector<uint32_t> stamps_;
+    std::vector<uint32_t> settled_stamps_;
+    std::vector<double> distances_;
+    std::vector<int> parents_;
+    std::vector<HeapEntry> heap_;
+};
+
+// Par de workspaces para búsquedas bidireccionales (hacia delante y atrás)
+struct BidirectionalWorkspace {
+    SearchWorkspace forward;
+    SearchWorkspace backward;
+
+    static BidirectionalWorkspace& for_current_thread();
+};
+
+} // namespace urban_transport
+
+#endif // SEARCH_WORKSPACE_H
@@ -0,0 +1,23 @@
+#ifndef SERVICE_TIME_H
+#define SERVICE_TIME_H
+
+#include <string>
+#include <string_view>
+#include <limits>
+
+namespace urban_transport {
+
+// Horas de servicio en segundos desde la medianoche del día de servicio.
+// Como en GTFS, las horas pueden pasar de 24 ("25:10:00") para viajes que
+// terminan después de medianoche.
+constexpr int NO_SERVICE_TIME = std::numeric_limits<int>::max();
+
+// Acepta "HH:MM:SS" o "HH:MM"; false si el texto no es una hora válida
+bool parse_service_time(std::string_view text, int& seconds);
+
+// Formato "HH:MM:SS" (las horas pueden superar 23)
+std::string format_service_time(int seconds);
+
+} // namespace urban_transport
+
+#endif // SERVICE_TIME_H
@@ -0,0 +1,62 @@
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include "geo_distance.h"
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+namespace urban_transport {
+
+// Resultado de una consulta espacial
+struct SpatialMatch {
+    int id;
+    double distance_km;
+};
+
+// Rejilla uniforme en grados sobre coordenadas (lat, lon). Cada celda mide
+// cell_size_km en latitud y los mismos grados en longitud; las consultas
+// corrigen el ancho de las celdas con el coseno de la latitud. Admite altas,
+// bajas y movimientos de puntos sin reconstruir la rejilla.
+class SpatialIndex {
+public:
+    explicit SpatialIndex(double cell_size_km = 0.5);
+
+    size_t size() const { return positions_.size(); }
+    bool empty() const { return positions_.empty(); }
+    void clear();
+
+    // Inserta o mueve el punto id
+    void insert(int id, double latitude, double longitude);
+    // false si el id no estaba indexado
+    bool remove(int id);
+
+    // Puntos a distancia Haversine <= radius_km, ordenados por distancia
+    std::vector<SpatialMatch> within_radius(double latitude, double longitude, double radius_km) const;
+
+    // Los k puntos más cercanos, ordenados por distancia
+    std::vector<SpatialMatch> nearest(double latitude, double longitude, size_t k) const;
+
+private:
+    // Puntos de una celda: ids y coordenadas en SoA para el núcleo por lotes
+    struct Cell {
+        std::vector<int> ids;
+        CoordinateBlock coordinates;
+    };
+
+    double cell_degrees_;
+    std::unordered_map<int64_t, Cell> cells_;
+    std::unordered_map<int, std::pair<double, double>> positions_;
+
+    int64_t cell_key(int64_t row, int64_t column) const;
+    int64_t row_of(double latitude) const;
+    int64_t column_of(double longitude) const;
+    void collect(const Cell& cell, double latitude, double longitude,
+                 double radius_km, std::vector<SpatialMatch>& matches) const;
+};
+
+} // namespace urban_transport
+
+#endif // SPATIAL_INDEX_H
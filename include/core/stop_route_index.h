@@ -0,0 +1,49 @@
+#ifndef STOP_ROUTE_INDEX_H
+#define STOP_ROUTE_INDEX_H
+
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+
+namespace urban_transport {
+
+// Índice invertido parada -> rutas en formato CSR. Cada entrada guarda la
+// ruta y la posición de la parada dentro de ella, ordenadas por id de ruta,
+// de modo que "rutas que pasan por A y luego por B" es una mezcla lineal de
+// dos listas cortas. También conserva la secuencia de paradas de cada ruta.
+class StopRouteIndex {
+public:
+    StopRouteIndex() = default;
+    explicit StopRouteIndex(const std::unordered_map<int, std::vector<int>>& route_stops);
+
+    size_t stop_count() const { return stop_ids_.size(); }
+    size_t route_count() const { return route_ids_.size(); }
+
+    // Ids de las rutas que pasan por la parada, ordenados y sin repetir
+    std::vector<int> routes_through(int stop_id) const;
+
+    // Rutas que pasan por from_stop y más adelante por to_stop
+    std::vector<int> direct_routes(int from_stop, int to_stop) const;
+
+    // Secuencia de paradas de la ruta (vacía si no existe)
+    std::vector<int> route_stops(int route_id) const;
+
+private:
+    std::vector<int> stop_ids_;
+    std::vector<uint32_t> stop_offsets_;
+    std::vector<int> entry_routes_;         // id de ruta
+    std::vector<uint32_t> entry_positions_; // posición en la ruta
+
+    std::vector<int> route_ids_;
+    std::vector<uint32_t> route_offsets_;
+    std::vector<int> route_sequence_;
+
+    int stop_index(int stop_id) const;
+
+    friend class NetworkSnapshot;
+};
+
+} // namespace urban_transport
+
+#endif // STOP_ROUTE_INDEX_H
@@ -0,0 +1,63 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <cstddef>
+
+namespace urban_transport {
+
+// Conjunto fijo de hilos para trabajos de datos en paralelo. Cada lote se
+// reparte en rangos contiguos, uno por hilo; un hilo que termina su rango
+// roba la mitad pendiente del rango de otro (work stealing).
+class ThreadPool {
+public:
+    using Task = std::function<void(size_t index, size_t worker)>;
+
+    // thread_count = 0 usa std::thread::hardware_concurrency()
+    explicit ThreadPool(size_t thread_count = 0);
+    ~ThreadPool();
+
+    size_t size() const { return workers_.size(); }
+
+    // Ejecuta task(i, worker) para cada i en [0, count) y espera a que
+    // terminen todos. worker identifica al hilo en [0, size()).
+    void parallel_for(size_t count, const Task& task);
+
+private:
+    // Rango [begin, end) pendiente de un hilo; el dueño consume por delante
+    // y los ladrones se llevan la mitad final
+    struct WorkRange {
+        std::mutex mutex;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    std::vector<std::thread> workers_;
+    std::vector<std::unique_ptr<WorkRange>> ranges_;
+    std::mutex mutex_;
+    std::mutex submit_mutex_;
+    std::condition_variable work_ready_;
+    std::condition_variable work_done_;
+
+    const Task* task_ = nullptr;
+    size_t active_workers_ = 0;
+    unsigned long generation_ = 0;
+    bool stopping_ = false;
+
+    void worker_loop(size_t worker);
+    bool take_next(size_t worker, size_t& index);
+    bool steal(size_t thief);
+
+    // Eliminar copia
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+};
+
+} // namespace urban_transport
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,93 @@
+#ifndef TIMETABLE_H
+#define TIMETABLE_H
+
+#include "service_time.h"
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace urban_transport {
+
+// Viaje con sus horas de paso (segundos de servicio) en orden de secuencia
+struct ScheduledTrip {
+    int trip_id;
+    std::vector<int> stop_ids;
+    std::vector<int> times;
+};
+
+// Tramo de un itinerario: se sube a trip_id en from_stop y se baja en to_stop
+struct JourneyLeg {
+    int trip_id;
+    int from_stop;
+    int to_stop;
+    int departure_time;
+    int arrival_time;
+};
+
+// Resultado de una consulta de llegada más temprana.
+// arrival_time es NO_SERVICE_TIME si el destino no es alcanzable.
+struct Journey {
+    int departure_time = 0;
+    int arrival_time = NO_SERVICE_TIME;
+    std::vector<JourneyLeg> legs;
+
+    bool found() const { return arrival_time != NO_SERVICE_TIME; }
+    size_t transfers() const { return legs.empty() ? 0 : legs.size() - 1; }
+};
+
+// Horario en arrays planos particionado por recorridos: un recorrido agrupa
+// los viajes con la misma secuencia de paradas que no se adelantan entre sí,
+// de modo que sus viajes quedan ordenados por hora en cada posición.
+// Las paradas se renumeran con índices densos en orden creciente de id.
+class Timetable {
+public:
+    Timetable() = default;
+    explicit Timetable(const std::vector<ScheduledTrip>& trips);
+
+    bool empty() const { return route_stop_offsets_.size() <= 1; }
+    size_t stop_count() const { return stop_ids_.size(); }
+    size_t route_count() const { return route_stop_offsets_.empty() ? 0 : route_stop_offsets_.size() - 1; }
+    size_t trip_count() const { return trip_ids_.size(); }
+
+    // Conversión id de parada <-> índice denso (-1 si el id no existe)
+    int index_of(int stop_id) const;
+    int stop_id(int index) const { return stop_ids_[index]; }
+
+    // Paradas del recorrido (índices densos) y viajes, ordenados por salida
+    size_t route_length(int route) const { return route_stop_offsets_[route + 1] - route_stop_offsets_[route]; }
+    int route_stop(int route, size_t position) const { return route_stops_[route_stop_offsets_[route] + position]; }
+    size_t route_trip_count(int route) const { return route_trip_offsets_[route + 1] - route_trip_offsets_[route]; }
+    int trip_id(int route, size_t trip) const { return trip_ids_[route_trip_offsets_[route] + trip]; }
+
+    // Hora de paso del viaje en una posición del recorrido
+    int stop_time(int route, size_t trip, size_t position) const {
+        return stop_times_[route_time_offsets_[route] + trip * route_length(route) + position];
+    }
+
+    // Primer viaje del recorrido que pasa por position a partir de time (-1 si ninguno)
+    int earliest_trip(int route, size_t position, int time) const;
+
+    // Recorridos que pasan por una parada, con la posición de la parada en cada uno
+    uint32_t stop_route_begin(int stop) const { return stop_route_offsets_[stop]; }
+    uint32_t stop_route_end(int stop) const { return stop_route_offsets_[stop + 1]; }
+    int stop_route(uint32_t entry) const { return stop_routes_[entry]; }
+    uint32_t stop_route_position(uint32_t entry) const { return stop_route_positions_[entry]; }
+
+private:
+    std::vector<int> stop_ids_;
+
+    std::vector<uint32_t> route_stop_offsets_;
+    std::vector<int> route_stops_;
+    std::vector<uint32_t> route_trip_offsets_;
+    std::vector<int> trip_ids_;
+    std::vector<uint32_t> route_time_offsets_;
+    std::vector<int> stop_times_; // por recorrido, viaje a viaje
+
+    std::vector<uint32_t> stop_route_offsets_;
+    std::vector<int> stop_routes_;
+    std::vector<uint32_t> stop_route_positions_;
+};
+
+} // namespace urban_transport
+
+#endif // TIMETABLE_H
@@ -0,0 +1,57 @@
+#ifndef TRIP_INTERVAL_INDEX_H
+#define TRIP_INTERVAL_INDEX_H
+
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+
+namespace urban_transport {
+
+// Intervalo de servicio de un viaje, en segundos desde la medianoche
+struct TripInterval {
+    int trip_id;
+    int start;
+    int end;
+};
+
+// Índice de intervalos de viajes en arrays paralelos ordenados por hora de
+// salida. Se guarda además la duración máxima: un viaje que circula en t
+// salió como pronto en t - max_duration, así que las consultas son una
+// búsqueda binaria más un recorrido acotado. Los resultados van ordenados
+// por salida y después por id de viaje.
+class TripIntervalIndex {
+public:
+    TripIntervalIndex() = default;
+    explicit TripIntervalIndex(std::vector<TripInterval> intervals);
+
+    size_t size() const { return trip_ids_.size(); }
+    bool empty() const { return trip_ids_.empty(); }
+    int max_duration() const { return max_duration_; }
+
+    // Alta o sustitución; O(n) por desplazar los arrays
+    void insert(int trip_id, int start, int end);
+    bool remove(int trip_id);
+
+    // Viajes que salen y llegan dentro de [from, until]
+    std::vector<int> within(int from, int until) const;
+    // Viajes que circulan en algún momento de [from, until]
+    std::vector<int> overlapping(int from, int until) const;
+    // Como overlapping, pero una ventana antes de las 24:00 también casa con
+    // los viajes del día de servicio anterior que siguen pasada la
+    // medianoche (horas >= 24:00:00)
+    std::vector<int> active_between(int from, int until) const;
+    std::vector<int> active_at(int time) const { return active_between(time, time); }
+
+private:
+    std::vector<int> starts_;   // ordenadas
+    std::vector<int> ends_;
+    std::vector<int> trip_ids_;
+    std::unordered_map<int, int> trip_starts_; // id -> salida, para localizarlo
+    int max_duration_ = 0;     // no baja al borrar: sigue siendo una cota válida
+
+    size_t position_of(int trip_id) const;
+};
+
+} // namespace urban_transport
+
+#endif // TRIP_INTERVAL_INDEX_H
@@ -0,0 +1,73 @@
+#ifndef CSV_READER_H
+#define CSV_READER_H
+
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+namespace urban_transport {
+
+// Lector CSV (RFC 4180) sobre un fichero mapeado en memoria con mmap. Los
+// campos son string_view sobre el mapeo, sin copias; solo los campos
+// entrecomillados con comillas escapadas ("") se copian a un búfer interno.
+// Las vistas valen hasta la siguiente llamada a next(). Las páginas ya
+// leídas se devuelven al sistema por bloques, así que la memoria residente
+// no crece con el tamaño del fichero. Sin mmap (Windows) se lee con
+// std::ifstream por una ventana fija que se rellena al agotarse.
+class CsvReader {
+public:
+    CsvReader() = default;
+    ~CsvReader();
+    CsvReader(const CsvReader&) = delete;
+    CsvReader& operator=(const CsvReader&) = delete;
+
+    // Mapea (o abre) el fichero y lee la cabecera (sin BOM UTF-8)
+    bool open(const std::string& path);
+    void close();
+    bool is_open() const { return data_ != nullptr || opened_empty_; }
+
+    const std::vector<std::string>& header() const { return header_; }
+    // Índice de la columna en la cabecera, o -1 si no existe
+    int column(std::string_view name) const;
+
+    // Siguiente registro; false al llegar al final. Las líneas vacías se saltan.
+    bool next(std::vector<std::string_view>& fields);
+
+    size_t size() const { return size_; }
+    size_t position() const { return base_ + position_; }
+
+private:
+    const char* data_ = nullptr; // mapeo entero o ventana de buffer_
+    size_t size_ = 0;            // tamaño del fichero
+    size_t limit_ = 0;           // bytes válidos desde data_
+    size_t base_ = 0;            // desplazamiento en el fichero de data_[0]
+    size_t position_ = 0;        // relativa a data_
+    size_t released_ = 0;
+    bool mapped_ = false;
+    std::ifstream file_;
+    std::vector<char> buffer_;
+    bool opened_empty_ = false;
+    std::vector<std::string> header_;
+
+    // Campos con comillas escapadas: (campo, desplazamiento en scratch_, longitud)
+    struct Unescaped {
+        size_t field;
+        size_t offset;
+        size_t length;
+    };
+    std::string scratch_;
+    std::vector<Unescaped> unescaped_;
+
+    void parse_record(std::vector<std::string_view>& fields);
+    // Desplaza lo pendiente al principio de la ventana y lee más; false si
+    // no queda nada por leer
+    bool refill();
+    bool more_input() const { return !mapped_ && file_.is_open() && file_.good(); }
+    void release_consumed();
+};
+
+} // namespace urban_transport
+
+#endif // CSV_READER_H
@@ -1,6 +1,7 @@
 #ifndef DB_H
 #define DB_H
 
+#include "row_view.h"
 #include <string>
 #include <memory>
 #include <vector>
@@ -28,11 +29,25 @@ public:
     bool query_with_params(const std::string& sql, 
                          const std::vector<std::string>& params,
                          RowCallback callback) const;
+
+    // Variantes tipadas (ver SQLiteWrapper)
+    bool execute_with_values(const std::string& sql, const std::vector<SqlParam>& params);
+    using RowViewCallback = std::function<bool(const RowView&)>;
+    bool query_rows(const std::string& sql, RowViewCallback callback) const;
+    bool query_rows(const std::string& sql, const std::vector<SqlParam>& params,
+                    RowViewCallback callback) const;
     
     // Transacciones
     bool begin_transaction();
     bool commit_transaction();
     bool rollback_transaction();
+    // Ejecuta body dentro de una transacción: confirma si devuelve true y
+    // revierte si devuelve false o falla el BEGIN
+    bool run_in_transaction(const std::function<bool()>& body);
+
+    // Traza DEBUG de cada sentencia y transacción (activa por defecto). Las
+    // cargas masivas la desactivan: el logger escribe y vacía cada línea.
+    void set_statement_logging(bool enabled);
 
 private:
     class Impl;
@@ -0,0 +1,59 @@
+#ifndef ROW_VIEW_H
+#define ROW_VIEW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+
+struct sqlite3_stmt;
+
+namespace urban_transport {
+
+// Parámetro tipado: enteros con sqlite3_bind_int64, reales con
+// sqlite3_bind_double y textos sin copia (el texto debe vivir hasta que
+// termine la llamada que lo vincula)
+class SqlParam {
+public:
+    using Value = std::variant<std::monostate, int64_t, double, std::string_view>;
+
+    SqlParam(std::nullptr_t) {}
+    template <typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    SqlParam(T value) : value_(static_cast<int64_t>(value)) {}
+    template <typename T, std::enable_if_t<std::is_floating_point_v<T>, int> = 0>
+    SqlParam(T value) : value_(static_cast<double>(value)) {}
+    SqlParam(const char* value) : value_(std::string_view(value)) {}
+    SqlParam(std::string_view value) : value_(value) {}
+    SqlParam(const std::string& value) : value_(std::string_view(value)) {}
+    // Guardaría una vista sobre un temporal ya destruido al vincularlo
+    SqlParam(std::string&&) = delete;
+
+    const Value& value() const { return value_; }
+
+private:
+    Value value_;
+};
+
+// Fila actual de una consulta, leída directamente del sqlite3_stmt. Solo es
+// válida dentro del callback; los string_view de get_text apuntan a memoria
+// de SQLite y hay que copiarlos si se quieren conservar.
+class RowView {
+public:
+    explicit RowView(sqlite3_stmt* stmt) : stmt_(stmt) {}
+
+    int column_count() const;
+    bool is_null(int column) const;
+    int get_int(int column) const;
+    int64_t get_int64(int column) const;
+    double get_double(int column) const;
+    std::string_view get_text(int column) const;
+
+private:
+    sqlite3_stmt* stmt_;
+};
+
+} // namespace urban_transport
+
+#endif // ROW_VIEW_H
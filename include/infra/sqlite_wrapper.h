@@ -1,14 +1,35 @@
 #ifndef SQLITE_WRAPPER_H
 #define SQLITE_WRAPPER_H
 
+#include "row_view.h"
 #include <sqlite3.h>
 #include <string>
 #include <vector>
+#include <list>
+#include <unordered_map>
 #include <memory>
+#include <mutex>
 #include <functional>
+#include <cstddef>
 
 namespace urban_transport {
 
+// Contadores de la caché de sentencias preparadas
+struct StatementCacheStats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t size = 0;     // sentencias en reposo dentro de la caché
+    size_t capacity = 0;
+};
+
+// Las sentencias de execute_with_params, query y query_with_params se
+// guardan preparadas por texto SQL (LRU, por conexión) y se reutilizan con
+// sqlite3_reset y sqlite3_clear_bindings. execute() no usa la caché porque
+// admite varios comandos en un mismo texto. La caché y sus contadores van
+// protegidos por un mutex, así que las consultas const pueden llamarse desde
+// varios hilos; una sentencia sacada de la caché solo la usa quien la tomó.
+// Las transacciones siguen siendo de la conexión: quien las use desde varios
+// hilos debe serializar las escrituras.
 class SQLiteWrapper {
 public:
     SQLiteWrapper();
@@ -28,6 +49,14 @@ public:
     bool query_with_params(const std::string& sql, 
                          const std::vector<std::string>& params,
                          RowCallback callback) const;
+
+    // Variantes tipadas: parámetros vinculados con su tipo y filas leídas
+    // sin convertir a std::string
+    bool execute_with_values(const std::string& sql, const std::vector<SqlParam>& params);
+    using RowViewCallback = std::function<bool(const RowView&)>;
+    bool query_rows(const std::string& sql, RowViewCallback callback) const;
+    bool query_rows(const std::string& sql, const std::vector<SqlParam>& params,
+                    RowViewCallback callback) const;
     
     // Transacciones
     bool begin_transaction();
@@ -38,9 +67,34 @@ public:
     std::string last_error() const;
     int last_error_code() const;
 
+    // Capacidad de la caché de sentencias (0 la desactiva)
+    void set_statement_cache_capacity(size_t capacity);
+    StatementCacheStats statement_cache_stats() const;
+
 private:
+    // Sentencia en reposo y su posición en la lista LRU
+    struct CachedStatement {
+        sqlite3_stmt* stmt;
+        std::list<std::string>::iterator position;
+    };
+
     sqlite3* db_ = nullptr;
-    
+
+    // Una sentencia en uso sale de la caché y vuelve al liberarla, así que
+    // una consulta anidada con el mismo SQL prepara la suya propia.
+    // statement_cache_mutex_ protege la lista, el mapa, la capacidad y los
+    // contadores; no se mantiene mientras se ejecuta una sentencia.
+    mutable std::mutex statement_cache_mutex_;
+    mutable std::list<std::string> statement_lru_; // delante, la más reciente
+    mutable std::unordered_map<std::string, CachedStatement> statement_cache_;
+    size_t statement_cache_capacity_ = 64;
+    mutable size_t statement_cache_hits_ = 0;
+    mutable size_t statement_cache_misses_ = 0;
+
+    sqlite3_stmt* acquire_statement(const std::string& sql) const;
+    static void bind_values(sqlite3_stmt* stmt, const std::vector<SqlParam>& params);
+    void release_statement(const std::string& sql, sqlite3_stmt* stmt) const;
+    void evict_statements(size_t capacity) const; // requiere statement_cache_mutex_
     void cleanup();
 };
 
@@ -0,0 +1,53 @@
+#ifndef GTFS_IMPORTER_H
+#define GTFS_IMPORTER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace urban_transport {
+
+// Resultado de importar un fichero del feed
+struct GtfsFileStats {
+    std::string file;
+    size_t rows = 0;    // filas importadas
+    size_t skipped = 0; // filas descartadas (referencias desconocidas o datos inválidos)
+    size_t bytes = 0;
+    double seconds = 0.0;
+
+    double rows_per_second() const { return seconds > 0.0 ? rows / seconds : 0.0; }
+};
+
+struct GtfsImportReport {
+    bool success = false;
+    std::string error;
+    std::vector<GtfsFileStats> files;
+};
+
+// Importa un feed GTFS descomprimido (stops.txt, routes.txt, trips.txt y
+// stop_times.txt) en las tablas de data/schema.sql. Los ids de GTFS son
+// textos: se asignan ids enteros a continuación de los existentes. Los CSV
+// se leen mapeados y en streaming, en transacciones de batch_size filas; la
+// memoria depende del número de paradas, rutas y viajes, no del tamaño de
+// stop_times.txt, cuyas filas de un mismo viaje no tienen por qué ir
+// seguidas. route_stops toma la secuencia completa del primer viaje de cada
+// ruta. Si la importación falla, los lotes ya confirmados se conservan.
+class GtfsImporter {
+public:
+    GtfsImporter();
+    ~GtfsImporter();
+
+    bool initialize(const std::string& db_path);
+    void set_batch_size(size_t rows);
+
+    GtfsImportReport import_directory(const std::string& directory);
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pimpl;
+};
+
+} // namespace urban_transport
+
+#endif // GTFS_IMPORTER_H
@@ -2,6 +2,7 @@
 #define ROUTE_SERVICE_H
 
 #include "transport.h"
+#include "core/entity_store.h"
 #include <vector>
 
 namespace urban_transport {
@@ -15,6 +16,11 @@ public:
     
     // CRUD operations
     bool create_route(const Route& route);
+    // Alta masiva de rutas con sus paradas (secuencia según stop_ids) en una
+    // sola transacción; si falla una fila no se crea nada
+    bool create_routes_with_stops(const std::vector<Route>& routes);
+    // Las lecturas se sirven desde una copia en memoria de las rutas con sus
+    // paradas, cargada en la primera lectura y mantenida por estas operaciones
     Route get_route(int id) const;
     std::vector<Route> get_all_routes() const;
     bool update_route(const Route& route);
@@ -26,6 +32,11 @@ public:
     bool add_stop_to_route(int route_id, int stop_id);
     bool remove_stop_from_route(int route_id, int stop_id);
 
+    // Caché de entidades: estadísticas y recarga tras cambios hechos por
+    // otras conexiones
+    EntityStoreStats cache_stats() const;
+    void invalidate_cache();
+
 private:
     class Impl;
     std::unique_ptr<Impl> pimpl;
@@ -2,6 +2,7 @@
 #define STOP_SERVICE_H
 
 #include "transport.h"
+#include "core/entity_store.h"
 #include <vector>
 
 namespace urban_transport {
@@ -15,15 +16,26 @@ public:
     
     // CRUD operations
     bool create_stop(const Stop& stop);
+    // Alta masiva en una sola transacción; si falla una fila no se crea ninguna
+    bool create_stops(const std::vector<Stop>& stops);
+    // get_stop y get_all_stops se sirven desde una copia en memoria de la
+    // tabla, cargada en la primera lectura y mantenida por estas operaciones
     Stop get_stop(int id) const;
     std::vector<Stop> get_all_stops() const;
     bool update_stop(const Stop& stop);
     bool delete_stop(int id);
     
     // Business logic
+    // Consultas servidas por un índice espacial en memoria, ordenadas por distancia
     std::vector<Stop> find_nearby_stops(double latitude, double longitude, double radius_km) const;
+    std::vector<Stop> find_nearest_stops(double latitude, double longitude, size_t count) const;
     std::vector<Route> get_routes_through_stop(int stop_id) const;
 
+    // Caché de entidades: estadísticas y recarga tras cambios hechos por
+    // otras conexiones
+    EntityStoreStats cache_stats() const;
+    void invalidate_cache();
+
 private:
     class Impl;
     std::unique_ptr<Impl> pimpl;
@@ -0,0 +1,23 @@
+#ifndef TIME_COLUMNS_H
+#define TIME_COLUMNS_H
+
+#include "infra/db.h"
+#include <string_view>
+
+namespace urban_transport {
+
+// Migración de las horas de texto a enteros: añade trips.start_seconds,
+// trips.end_seconds y trip_stops.arrival_seconds (segundos desde la
+// medianoche del día de servicio, pueden pasar de 24:00), rellena las filas
+// que aún no los tienen y crea los índices de cobertura para consultas por
+// franja horaria. Es idempotente y barata si ya está aplicada. Devuelve
+// false si faltan las tablas o falla algún paso (en ese caso no cambia nada).
+bool migrate_time_columns(Database& db);
+
+// Valor para una columna *_seconds: los segundos de la hora, o NULL si el
+// texto no es una hora válida (p. ej. paradas sin hora)
+SqlParam service_seconds_param(std::string_view time);
+
+} // namespace urban_transport
+
+#endif // TIME_COLUMNS_H
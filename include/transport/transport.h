@@ -1,9 +1,14 @@
 #ifndef TRANSPORT_H
 #define TRANSPORT_H
 
+#include "core/timetable.h"
+#include "core/connection_table.h"
+#include "core/entity_store.h"
 #include <string>
 #include <vector>
 #include <memory>
+#include <utility>
+#include <cstdint>
 
 namespace urban_transport {
 
@@ -38,12 +43,62 @@ struct Trip {
         : id(id), route_id(route_id), start_time(start), end_time(end) {}
 };
 
+// Memoria dinámica (cadenas y vectores) de cada entidad, para las
+// estadísticas de EntityStore
+inline size_t entity_heap_bytes(const Stop& stop) {
+    return stop.name.capacity();
+}
+
+inline size_t entity_heap_bytes(const Route& route) {
+    return route.name.capacity() + route.transport_type.capacity() + route.stop_ids.capacity() * sizeof(int);
+}
+
+inline size_t entity_heap_bytes(const Trip& trip) {
+    return trip.start_time.capacity() + trip.end_time.capacity() + trip.stop_sequence.capacity() * sizeof(int);
+}
+
+struct EntityCacheStats {
+    EntityStoreStats stops;
+    EntityStoreStats routes;
+};
+
+// Motor usado por TransportSystem::find_shortest_path
+enum class RoutingAlgorithm {
+    DIJKSTRA,
+    ASTAR,
+    BIDIRECTIONAL,
+    CONTRACTION_HIERARCHY, // requiere preprocesado al seleccionarse
+    LANDMARKS              // ALT; tolera cambios de peso sin repetir el preprocesado
+};
+
+// Concurrencia: las consultas de enrutamiento (find_shortest_path,
+// find_shortest_paths, distance_matrix, reachable_within, earliest_arrival,
+// departure_profile, find_routes_through_stop, find_direct_routes,
+// routing_algorithm) pueden llamarse desde varios hilos a la vez, también
+// mientras otro hilo modifica el grafo (add_stop, add_route,
+// update_edge_weight, set_routing_algorithm...). Cada consulta fija con una
+// carga atómica la instantánea inmutable actual (grafo e índices) y ve la
+// versión anterior o la nueva, nunca una a medias; los lectores no esperan
+// nunca a un escritor. Los escritores se serializan entre sí. Las lecturas
+// de entidades (get_stop, get_route...) también son seguras entre hilos; la
+// que tiene que cargar la tabla (la primera o tras invalidate_entity_cache)
+// espera a que termine la escritura en curso en la base de datos y nunca ve
+// una transacción a medias.
 class TransportSystem {
 public:
     TransportSystem();
     ~TransportSystem();
     
     bool initialize(const std::string& db_path);
+    // Arranca desde la instantánea binaria de la red si existe y la base de
+    // datos no ha cambiado desde que se escribió; si no, construye la red
+    // desde la base de datos y reescribe la instantánea. Los horarios se
+    // cargan siempre de la base de datos.
+    bool initialize(const std::string& db_path, const std::string& snapshot_path);
+    // Guarda la red en memoria como instantánea. Si hay pesos cambiados con
+    // update_edge_weight la instantánea lo indica, e initialize no la acepta
+    // como la red de la base de datos: la reconstruye y la sobrescribe.
+    bool save_snapshot(const std::string& path) const;
     void shutdown();
     
     // Gestión de paradas
@@ -55,6 +110,13 @@ public:
     bool add_route(const Route& route);
     Route get_route(int id) const;
     std::vector<Route> get_all_routes() const;
+
+    // get_stop, get_all_stops, get_route y get_all_routes se sirven desde
+    // copias en memoria cargadas en la primera lectura y mantenidas por
+    // add_stop/add_route. invalidate_entity_cache() las recarga tras cambios
+    // hechos por otras conexiones.
+    EntityCacheStats entity_cache_stats() const;
+    void invalidate_entity_cache();
     
     // Gestión de viajes
     bool add_trip(const Trip& trip);
@@ -62,7 +124,39 @@ public:
     
     // Algoritmos
     std::vector<int> find_shortest_path(int start_stop, int end_stop) const;
+    // Resuelve un lote de pares (origen, destino) en el pool de consultas;
+    // el resultado i corresponde a queries[i]
+    std::vector<std::vector<int>> find_shortest_paths(
+        const std::vector<std::pair<int, int>>& queries) const;
+    // Paradas (id, km) alcanzables desde stop_id recorriendo como mucho
+    // max_distance km, en orden creciente de distancia
+    std::vector<std::pair<int, double>> reachable_within(int stop_id, double max_distance) const;
+    // Itinerario con llegada más temprana según el horario (trips/trip_stops),
+    // saliendo a partir de departure_time ("HH:MM:SS") con como mucho
+    // max_transfers transbordos
+    Journey earliest_arrival(int start_stop, int end_stop,
+                             const std::string& departure_time,
+                             int max_transfers) const;
+    // Salidas Pareto-óptimas de start_stop a end_stop dentro de la ventana
+    // ("HH:MM:SS"), con la llegada de cada una; sirve para paneles de salidas
+    std::vector<ProfileEntry> departure_profile(int start_stop, int end_stop,
+                                                const std::string& window_start,
+                                                const std::string& window_end) const;
+    void set_routing_algorithm(RoutingAlgorithm algorithm);
+    RoutingAlgorithm routing_algorithm() const;
+    // Versión de la instantánea publicada; crece con cada modificación de la red
+    uint64_t network_version() const;
+    void set_landmark_count(size_t count);
+    // Ajusta el coste de un tramo dirigido (p. ej. por retrasos)
+    bool update_edge_weight(int from_stop, int to_stop, double weight);
+    // Servidas desde el índice en memoria parada -> rutas
     std::vector<Route> find_routes_through_stop(int stop_id) const;
+    // Rutas que pasan por from_stop y después por to_stop
+    std::vector<Route> find_direct_routes(int from_stop, int to_stop) const;
+    // Distancias (km) entre cada origen y destino, fila por origen;
+    // infinito si no hay camino. Solo usa el grafo en memoria.
+    std::vector<double> distance_matrix(const std::vector<int>& sources,
+                                        const std::vector<int>& targets) const;
 
 private:
     class Impl;
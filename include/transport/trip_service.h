@@ -2,10 +2,19 @@
 #define TRIP_SERVICE_H
 
 #include "transport.h"
+#include "core/entity_store.h"
+#include "core/departure_board.h"
 #include <vector>
 
 namespace urban_transport {
 
+// Viaje con la hora de llegada ("HH:MM:SS") a cada parada de
+// trip.stop_sequence, en el mismo orden
+struct TripSchedule {
+    Trip trip;
+    std::vector<std::string> arrival_times;
+};
+
 class TripService {
 public:
     TripService();
@@ -15,6 +24,12 @@ public:
     
     // CRUD operations
     bool create_trip(const Trip& trip);
+    // Alta masiva de viajes con sus horas de paso en una sola transacción;
+    // si falla una fila o faltan horas no se crea nada
+    bool create_trips_with_stop_times(const std::vector<TripSchedule>& schedules);
+    // get_trip, get_all_trips y get_trip_stops se sirven desde una copia en
+    // memoria de los viajes con sus paradas, cargada en la primera lectura y
+    // mantenida por estas operaciones
     Trip get_trip(int id) const;
     std::vector<Trip> get_all_trips() const;
     bool update_trip(const Trip& trip);
@@ -22,11 +37,36 @@ public:
     
     // Business logic
     std::vector<Trip> find_trips_by_route(int route_id) const;
+    // Las consultas por franja ("HH:MM:SS", también 24:00:00 o más) comparan
+    // segundos en un índice de intervalos en memoria, ordenadas por salida.
+    // Viajes que salen y llegan dentro de la franja:
     std::vector<Trip> find_trips_by_time_range(const std::string& start_time, 
                                               const std::string& end_time) const;
+    // Viajes en circulación en algún momento de la franja o en un instante;
+    // antes de las 24:00 incluyen los del día de servicio anterior que siguen
+    // circulando pasada la medianoche
+    std::vector<Trip> find_trips_active_between(const std::string& start_time,
+                                                const std::string& end_time) const;
+    std::vector<Trip> find_trips_active_at(const std::string& time) const;
+    // sequence <= 0 añade la parada al final del viaje
     bool add_stop_to_trip(int trip_id, int stop_id, int sequence);
+    bool add_stop_to_trip(int trip_id, int stop_id, int sequence, const std::string& arrival_time);
     std::vector<int> get_trip_stops(int trip_id) const;
 
+    // Panel de salidas servido desde memoria (ver DepartureBoard). Las horas
+    // devueltas son del día de servicio de cada viaje: de madrugada pueden
+    // aparecer como 24:xx del día anterior.
+    // Próximas count salidas de la parada a partir de after ("HH:MM:SS")
+    std::vector<Departure> next_departures(int stop_id, const std::string& after, size_t count) const;
+    // Salidas entre after y until agrupadas por ruta, como mucho per_route cada una
+    std::vector<RouteDepartures> next_departures_by_route(int stop_id, const std::string& after,
+                                                          const std::string& until, size_t per_route) const;
+
+    // Caché de entidades: estadísticas y recarga tras cambios hechos por
+    // otras conexiones
+    EntityStoreStats cache_stats() const;
+    void invalidate_cache();
+
 private:
     class Impl;
     std::unique_ptr<Impl> pimpl;
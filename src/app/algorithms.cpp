@@ -6,24 +6,107 @@
 #include <limits>
 #include <cmath>
 #include <algorithm>
+#include <iterator>
 
 using namespace urban_transport;
 
 constexpr double EARTH_RADIUS_KM = 6371.0;
+constexpr double PI = 3.14159265358979323846;
 static const double INF = std::numeric_limits<double>::infinity();
 
+namespace {
+
+// Reconstruye el camino (ids de parada) siguiendo los padres del workspace
+std::vector<int> build_path(const CsrGraph& graph, const SearchWorkspace& workspace, int target) {
+    std::vector<int> path;
+    for (int node = target; node != -1; node = workspace.parent(node)) {
+        path.push_back(graph.node_id(node));
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+// A* genérico: heuristic(índice) debe ser una cota inferior consistente de
+// la distancia al destino; infinito descarta el nodo
+template <typename Heuristic>
+std::vector<int> goal_directed_search(const CsrGraph& graph, int start_node, int end_node,
+                                      SearchWorkspace& workspace, Heuristic heuristic) {
+    int source = graph.index_of(start_node);
+    int target = graph.index_of(end_node);
+    if (source < 0 || target < 0) return {};
+    if (source == target) return {start_node};
+
+    double source_estimate = heuristic(source);
+    if (source_estimate == INF) return {};
+
+    workspace.reset(graph.node_count());
+    workspace.set_distance(source, 0.0, -1);
+    workspace.push(source_estimate, source);
+
+    while (!workspace.heap_empty()) {
+        int current = workspace.pop().node;
+        if (workspace.settled(current)) continue;
+        workspace.settle(current);
+
+        if (current == target) return build_path(graph, workspace, target);
+
+        double current_dist = workspace.distance(current);
+        for (uint32_t e = graph.edge_begin(current); e < graph.edge_end(current); ++e) {
+            int next = graph.edge_target(e);
+            if (workspace.settled(next)) continue;
+            double new_dist = current_dist + graph.edge_weight(e);
+            if (new_dist < workspace.distance(next)) {
+                double estimate = heuristic(next);
+                if (estimate == INF) continue;
+                workspace.set_distance(next, new_dist, current);
+                workspace.push(new_dist + estimate, next);
+            }
+        }
+    }
+
+    return {};
+}
+
+// Dijkstra acotado: añade a reached las paradas con coste <= budget en
+// orden de asentamiento. No inserta en el montículo lo que supera el límite.
+void bounded_search(const CsrGraph& graph, int source, double budget,
+                    SearchWorkspace& workspace, std::vector<ReachableStop>& reached) {
+    reached.clear();
+    if (source < 0 || budget < 0.0) return;
+
+    workspace.reset(graph.node_count());
+    workspace.set_distance(source, 0.0, -1);
+    workspace.push(0.0, source);
+
+    while (!workspace.heap_empty()) {
+        auto [current_dist, current] = workspace.pop();
+        if (workspace.settled(current)) continue;
+        workspace.settle(current);
+        reached.push_back({graph.node_id(current), current_dist});
+
+        for (uint32_t e = graph.edge_begin(current); e < graph.edge_end(current); ++e) {
+            int next = graph.edge_target(e);
+            double new_dist = current_dist + graph.edge_weight(e);
+            if (new_dist <= budget && new_dist < workspace.distance(next)) {
+                workspace.set_distance(next, new_dist, current);
+                workspace.push(new_dist, next);
+            }
+        }
+    }
+}
+
+} // namespace
+
 std::vector<int> TransportAlgorithms::dijkstra_shortest_path(const Graph& graph,
                                                              int start_node,
                                                              int end_node) {
     if (!graph.has_node(start_node) || !graph.has_node(end_node)) return {};
     if (start_node == end_node) return {start_node};
 
+    // Solo se guardan los nodos alcanzados; los ausentes valen infinito
     std::unordered_map<int, double> distances;
     std::unordered_map<int, int> previous;
     std::unordered_set<int> visited;
-
-    auto nodes = graph.get_all_nodes();
-    for (int node : nodes) distances[node] = INF;
     distances[start_node] = 0.0;
 
     using Pair = std::pair<double, int>;
@@ -50,7 +133,8 @@ std::vector<int> TransportAlgorithms::dijkstra_shortest_path(const Graph& graph,
 
         for (const auto& edge : graph.get_edges(current_node)) {
             double new_dist = current_dist + edge.weight;
-            if (new_dist < distances[edge.target]) {
+            auto it = distances.find(edge.target);
+            if (it == distances.end() || new_dist < it->second) {
                 distances[edge.target] = new_dist;
                 previous[edge.target] = current_node;
                 pq.push({new_dist, edge.target});
@@ -61,6 +145,523 @@ std::vector<int> TransportAlgorithms::dijkstra_shortest_path(const Graph& graph,
     return {};
 }
 
+std::vector<int> TransportAlgorithms::dijkstra_shortest_path(const CsrGraph& graph,
+                                                             int start_node,
+                                                             int end_node) {
+    return dijkstra_shortest_path(graph, start_node, end_node,
+                                  SearchWorkspace::for_current_thread());
+}
+
+std::vector<int> TransportAlgorithms::dijkstra_shortest_path(const CsrGraph& graph,
+                                                             int start_node,
+                                                             int end_node,
+                                                             SearchWorkspace& workspace) {
+    int source = graph.index_of(start_node);
+    int target = graph.index_of(end_node);
+    if (source < 0 || target < 0) return {};
+    if (source == target) return {start_node};
+
+    workspace.reset(graph.node_count());
+    workspace.set_distance(source, 0.0, -1);
+    workspace.push(0.0, source);
+
+    while (!workspace.heap_empty()) {
+        auto [current_dist, current] = workspace.pop();
+        if (workspace.settled(current)) continue;
+        workspace.settle(current);
+
+        if (current == target) return build_path(graph, workspace, target);
+
+        for (uint32_t e = graph.edge_begin(current); e < graph.edge_end(current); ++e) {
+            int next = graph.edge_target(e);
+            double new_dist = current_dist + graph.edge_weight(e);
+            if (new_dist < workspace.distance(next)) {
+                workspace.set_distance(next, new_dist, current);
+                workspace.push(new_dist, next);
+            }
+        }
+    }
+
+    return {};
+}
+
+std::vector<int> TransportAlgorithms::astar_shortest_path(const CsrGraph& graph,
+                                                          int start_node,
+                                                          int end_node) {
+    return astar_shortest_path(graph, start_node, end_node,
+                               SearchWorkspace::for_current_thread());
+}
+
+std::vector<int> TransportAlgorithms::astar_shortest_path(const CsrGraph& graph,
+                                                          int start_node,
+                                                          int end_node,
+                                                          SearchWorkspace& workspace) {
+    int target = graph.index_of(end_node);
+    if (target < 0) return {};
+
+    const bool target_located = graph.has_coordinates(target);
+    const double target_lat = graph.latitude(target);
+    const double target_lon = graph.longitude(target);
+
+    // El factor absorbe el redondeo para que la cota nunca sobreestime
+    return goal_directed_search(graph, start_node, end_node, workspace, [&](int node) {
+        if (!target_located || !graph.has_coordinates(node)) return 0.0;
+        return calculate_distance(graph.latitude(node), graph.longitude(node),
+                                  target_lat, target_lon) * (1.0 - 1e-9);
+    });
+}
+
+std::vector<int> TransportAlgorithms::alt_shortest_path(const CsrGraph& graph,
+                                                        const LandmarkIndex& landmarks,
+                                                        int start_node,
+                                                        int end_node) {
+    return alt_shortest_path(graph, landmarks, start_node, end_node,
+                             SearchWorkspace::for_current_thread());
+}
+
+std::vector<int> TransportAlgorithms::alt_shortest_path(const CsrGraph& graph,
+                                                        const LandmarkIndex& landmarks,
+                                                        int start_node,
+                                                        int end_node,
+                                                        SearchWorkspace& workspace) {
+    // Landmarks calculados sobre otro conjunto de nodos: se degrada a Dijkstra
+    if (landmarks.node_count() != graph.node_count()) {
+        return dijkstra_shortest_path(graph, start_node, end_node, workspace);
+    }
+
+    int target = graph.index_of(end_node);
+    if (target < 0) return {};
+    return goal_directed_search(graph, start_node, end_node, workspace, [&](int node) {
+        return landmarks.lower_bound(node, target);
+    });
+}
+
+std::vector<int> TransportAlgorithms::bidirectional_dijkstra(const CsrGraph& graph,
+                                                             int start_node,
+                                                             int end_node) {
+    return bidirectional_dijkstra(graph, start_node, end_node,
+                                  BidirectionalWorkspace::for_current_thread());
+}
+
+std::vector<int> TransportAlgorithms::bidirectional_dijkstra(const CsrGraph& graph,
+                                                             int start_node,
+                                                             int end_node,
+                                                             BidirectionalWorkspace& workspace) {
+    int source = graph.index_of(start_node);
+    int target = graph.index_of(end_node);
+    if (source < 0 || target < 0) return {};
+    if (source == target) return {start_node};
+
+    SearchWorkspace& forward = workspace.forward;
+    SearchWorkspace& backward = workspace.backward;
+    forward.reset(graph.node_count());
+    backward.reset(graph.node_count());
+    forward.set_distance(source, 0.0, -1);
+    forward.push(0.0, source);
+    backward.set_distance(target, 0.0, -1);
+    backward.push(0.0, target);
+
+    double best = INF;
+    int meeting = -1;
+
+    while (!forward.heap_empty() && !backward.heap_empty()) {
+        if (forward.top().key + backward.top().key >= best) break;
+
+        bool expand_forward = forward.top().key <= backward.top().key;
+        SearchWorkspace& self = expand_forward ? forward : backward;
+        SearchWorkspace& other = expand_forward ? backward : forward;
+
+        int current = self.pop().node;
+        if (self.settled(current)) continue;
+        self.settle(current);
+
+        double current_dist = self.distance(current);
+        if (other.reached(current) && current_dist + other.distance(current) < best) {
+            best = current_dist + other.distance(current);
+            meeting = current;
+        }
+
+        uint32_t begin = expand_forward ? graph.edge_begin(current) : graph.in_edge_begin(current);
+        uint32_t end = expand_forward ? graph.edge_end(current) : graph.in_edge_end(current);
+        for (uint32_t e = begin; e < end; ++e) {
+            int next = expand_forward ? graph.edge_target(e) : graph.in_edge_source(e);
+            double weight = expand_forward ? graph.edge_weight(e) : graph.in_edge_weight(e);
+            double new_dist = current_dist + weight;
+            if (new_dist < self.distance(next)) {
+                self.set_distance(next, new_dist, current);
+                self.push(new_dist, next);
+            }
+            if (other.reached(next) && new_dist + other.distance(next) < best) {
+                best = new_dist + other.distance(next);
+                meeting = next;
+            }
+        }
+    }
+
+    if (meeting < 0) return {};
+
+    // Tramo origen -> encuentro por los padres hacia delante, luego
+    // encuentro -> destino por los padres de la búsqueda inversa
+    std::vector<int> path = build_path(graph, forward, meeting);
+    for (int node = backward.parent(meeting); node != -1; node = backward.parent(node)) {
+        path.push_back(graph.node_id(node));
+    }
+    return path;
+}
+
+std::vector<double> TransportAlgorithms::distance_matrix(const CsrGraph& graph,
+                                                        const std::vector<int>& sources,
+                                                        const std::vector<int>& targets,
+                                                        ThreadPool& pool) {
+    const size_t columns = targets.size();
+    std::vector<double> matrix(sources.size() * columns, INF);
+    if (matrix.empty()) return matrix;
+
+    std::vector<int> target_index(columns);
+    std::vector<char> is_target(graph.node_count(), 0);
+    size_t distinct_targets = 0;
+    for (size_t j = 0; j < columns; ++j) {
+        target_index[j] = graph.index_of(targets[j]);
+        if (target_index[j] >= 0 && !is_target[target_index[j]]) {
+            is_target[target_index[j]] = 1;
+            ++distinct_targets;
+        }
+    }
+
+    // Cada hilo del pool reutiliza su propio workspace entre orígenes
+    pool.parallel_for(sources.size(), [&](size_t row, size_t) {
+        int source = graph.index_of(sources[row]);
+        if (source < 0) return;
+
+        SearchWorkspace& workspace = SearchWorkspace::for_current_thread();
+        workspace.reset(graph.node_count());
+        workspace.set_distance(source, 0.0, -1);
+        workspace.push(0.0, source);
+
+        size_t pending = distinct_targets;
+        while (pending > 0 && !workspace.heap_empty()) {
+            auto [current_dist, current] = workspace.pop();
+            if (workspace.settled(current)) continue;
+            workspace.settle(current);
+            if (is_target[current]) --pending;
+
+            for (uint32_t e = graph.edge_begin(current); e < graph.edge_end(current); ++e) {
+                int next = graph.edge_target(e);
+                double new_dist = current_dist + graph.edge_weight(e);
+                if (new_dist < workspace.distance(next)) {
+                    workspace.set_distance(next, new_dist, current);
+                    workspace.push(new_dist, next);
+                }
+            }
+        }
+
+        double* out = &matrix[row * columns];
+        for (size_t j = 0; j < columns; ++j) {
+            int target = target_index[j];
+            if (target >= 0 && workspace.settled(target)) out[j] = workspace.distance(target);
+        }
+    });
+
+    return matrix;
+}
+
+std::vector<ReachableStop> TransportAlgorithms::isochrone(const CsrGraph& graph,
+                                                         int start_node,
+                                                         double budget) {
+    std::vector<ReachableStop> reached;
+    isochrone(graph, start_node, budget, SearchWorkspace::for_current_thread(), reached);
+    return reached;
+}
+
+void TransportAlgorithms::isochrone(const CsrGraph& graph,
+                                    int start_node,
+                                    double budget,
+                                    SearchWorkspace& workspace,
+                                    std::vector<ReachableStop>& reached) {
+    bounded_search(graph, graph.index_of(start_node), budget, workspace, reached);
+}
+
+void TransportAlgorithms::isochrone_bands(const CsrGraph& graph,
+                                          int start_node,
+                                          const std::vector<double>& budgets,
+                                          SearchWorkspace& workspace,
+                                          std::vector<ReachableStop>& reached,
+                                          std::vector<size_t>& band_offsets) {
+    band_offsets.assign(budgets.size() + 1, 0);
+    if (budgets.empty()) {
+        reached.clear();
+        return;
+    }
+    bounded_search(graph, graph.index_of(start_node), budgets.back(), workspace, reached);
+
+    // reached está ordenado por coste: cada banda es un tramo contiguo
+    size_t position = 0;
+    for (size_t b = 0; b < budgets.size(); ++b) {
+        while (position < reached.size() && reached[position].cost <= budgets[b]) ++position;
+        band_offsets[b + 1] = position;
+    }
+}
+
+std::vector<size_t> TransportAlgorithms::catchment_counts(const CsrGraph& graph,
+                                                          const std::vector<double>& budgets,
+                                                          ThreadPool& pool) {
+    const size_t columns = budgets.size();
+    std::vector<size_t> counts(graph.node_count() * columns, 0);
+    if (counts.empty()) return counts;
+
+    // Un buffer de salida por hilo, reutilizado entre orígenes
+    std::vector<std::vector<ReachableStop>> buffers(pool.size());
+    pool.parallel_for(graph.node_count(), [&](size_t source, size_t worker) {
+        std::vector<ReachableStop>& reached = buffers[worker];
+        bounded_search(graph, static_cast<int>(source), budgets.back(),
+                       SearchWorkspace::for_current_thread(), reached);
+
+        size_t* out = &counts[source * columns];
+        size_t position = 0;
+        for (size_t b = 0; b < columns; ++b) {
+            while (position < reached.size() && reached[position].cost <= budgets[b]) ++position;
+            out[b] = position;
+        }
+    });
+
+    return counts;
+}
+
+Journey TransportAlgorithms::raptor_earliest_arrival(const Timetable& timetable,
+                                                     int start_stop,
+                                                     int end_stop,
+                                                     int departure_time,
+                                                     int max_transfers) {
+    Journey journey;
+    journey.departure_time = departure_time;
+
+    int source = timetable.index_of(start_stop);
+    int target = timetable.index_of(end_stop);
+    if (source < 0 || target < 0 || max_transfers < 0) return journey;
+    if (source == target) {
+        journey.arrival_time = departure_time;
+        return journey;
+    }
+
+    // Etiqueta de la ronda k: viaje que mejoró la parada en esa ronda
+    // (route = -1 si la hora se hereda de la ronda anterior)
+    struct Label {
+        int route = -1;
+        int trip = -1;
+        int board_position = -1;
+        int alight_position = -1;
+    };
+
+    const size_t n = timetable.stop_count();
+    const size_t rounds = static_cast<size_t>(max_transfers) + 2; // ronda 0 + un viaje por ronda
+    std::vector<int> arrival(rounds * n, NO_SERVICE_TIME);
+    std::vector<Label> labels(rounds * n);
+    std::vector<int> best(n, NO_SERVICE_TIME);
+    std::vector<int> queue_position(timetable.route_count(), -1);
+    std::vector<int> queued_routes;
+    std::vector<char> is_marked(n, 0);
+    std::vector<int> marked = {source};
+
+    arrival[source] = departure_time;
+    best[source] = departure_time;
+
+    size_t last_round = 0;
+    for (size_t k = 1; k < rounds && !marked.empty(); ++k) {
+        const int* previous = &arrival[(k - 1) * n];
+        int* current = &arrival[k * n];
+        std::copy(previous, previous + n, current);
+
+        // Cada recorrido se recorre desde la primera parada marcada
+        queued_routes.clear();
+        for (int stop : marked) {
+            is_marked[stop] = 0;
+            for (uint32_t e = timetable.stop_route_begin(stop); e < timetable.stop_route_end(stop); ++e) {
+                int route = timetable.stop_route(e);
+                int position = static_cast<int>(timetable.stop_route_position(e));
+                if (queue_position[route] < 0) {
+                    queued_routes.push_back(route);
+                    queue_position[route] = position;
+                } else {
+                    queue_position[route] = std::min(queue_position[route], position);
+                }
+            }
+        }
+        marked.clear();
+
+        for (int route : queued_routes) {
+            const size_t length = timetable.route_length(route);
+            int trip = -1;
+            int board_position = -1;
+            for (size_t position = static_cast<size_t>(queue_position[route]); position < length; ++position) {
+                int stop = timetable.route_stop(route, position);
+
+                if (trip >= 0) {
+                    int time = timetable.stop_time(route, trip, position);
+                    // Poda por destino: no sirve llegar después del mejor conocido
+                    if (time < best[stop] && time < best[target]) {
+                        current[stop] = time;
+                        best[stop] = time;
+                        labels[k * n + stop] = {route, trip, board_position, static_cast<int>(position)};
+                        if (!is_marked[stop]) {
+                            is_marked[stop] = 1;
+                            marked.push_back(stop);
+                        }
+                    }
+                }
+
+                // ¿Se puede tomar aquí un viaje anterior del mismo recorrido?
+                if (previous[stop] != NO_SERVICE_TIME &&
+                    (trip < 0 || previous[stop] <= timetable.stop_time(route, trip, position))) {
+                    int earlier = timetable.earliest_trip(route, position, previous[stop]);
+                    if (earlier >= 0 && (trip < 0 || earlier < trip)) {
+                        trip = earlier;
+                        board_position = static_cast<int>(position);
+                    }
+                }
+            }
+            queue_position[route] = -1;
+        }
+        last_round = k;
+    }
+
+    if (best[target] == NO_SERVICE_TIME) return journey;
+    journey.arrival_time = best[target];
+
+    // Primera ronda que alcanza la mejor hora: el menor número de viajes
+    size_t k = 1;
+    while (k < last_round && arrival[k * n + target] != best[target]) ++k;
+
+    int stop = target;
+    while (k > 0) {
+        const Label& label = labels[k * n + stop];
+        if (label.route < 0) {
+            --k;
+            continue;
+        }
+        int board_stop = timetable.route_stop(label.route, label.board_position);
+        journey.legs.push_back({
+            timetable.trip_id(label.route, label.trip),
+            timetable.stop_id(board_stop),
+            timetable.stop_id(stop),
+            timetable.stop_time(label.route, label.trip, label.board_position),
+            timetable.stop_time(label.route, label.trip, label.alight_position)
+        });
+        stop = board_stop;
+        --k;
+    }
+    std::reverse(journey.legs.begin(), journey.legs.end());
+    return journey;
+}
+
+Journey TransportAlgorithms::csa_earliest_arrival(const ConnectionTable& connections,
+                                                  int start_stop,
+                                                  int end_stop,
+                                                  int departure_time) {
+    Journey journey;
+    journey.departure_time = departure_time;
+
+    int source = connections.index_of(start_stop);
+    int target = connections.index_of(end_stop);
+    if (source < 0 || target < 0) return journey;
+    if (source == target) {
+        journey.arrival_time = departure_time;
+        return journey;
+    }
+
+    // Por parada: conexiones de subida y bajada del último tramo que la mejoró
+    struct Pointer {
+        size_t enter = 0;
+        size_t exit = 0;
+    };
+    const size_t NOT_BOARDED = std::numeric_limits<size_t>::max();
+
+    std::vector<int> arrival(connections.stop_count(), NO_SERVICE_TIME);
+    std::vector<Pointer> pointers(connections.stop_count());
+    std::vector<size_t> boarded(connections.trip_count(), NOT_BOARDED);
+    arrival[source] = departure_time;
+
+    for (size_t i = connections.first_departure(departure_time); i < connections.connection_count(); ++i) {
+        const Connection& c = connections.connection(i);
+        if (c.departure_time >= arrival[target]) break;
+
+        if (boarded[c.trip] == NOT_BOARDED) {
+            if (arrival[c.departure_stop] > c.departure_time) continue;
+            boarded[c.trip] = i;
+        }
+        if (c.arrival_time < arrival[c.arrival_stop]) {
+            arrival[c.arrival_stop] = c.arrival_time;
+            pointers[c.arrival_stop] = {boarded[c.trip], i};
+        }
+    }
+
+    if (arrival[target] == NO_SERVICE_TIME) return journey;
+    journey.arrival_time = arrival[target];
+
+    for (int stop = target; stop != source;) {
+        const Connection& enter = connections.connection(pointers[stop].enter);
+        const Connection& exit = connections.connection(pointers[stop].exit);
+        journey.legs.push_back({
+            connections.trip_id(enter.trip),
+            connections.stop_id(enter.departure_stop),
+            connections.stop_id(exit.arrival_stop),
+            enter.departure_time,
+            exit.arrival_time
+        });
+        stop = enter.departure_stop;
+    }
+    std::reverse(journey.legs.begin(), journey.legs.end());
+    return journey;
+}
+
+std::vector<ProfileEntry> TransportAlgorithms::csa_profile(const ConnectionTable& connections,
+                                                           int start_stop,
+                                                           int end_stop,
+                                                           int window_start,
+                                                           int window_end) {
+    int source = connections.index_of(start_stop);
+    int target = connections.index_of(end_stop);
+    if (source < 0 || target < 0 || source == target || window_end < window_start) return {};
+
+    // Perfil de cada parada en orden decreciente de salida; la llegada
+    // también decrece, así que basta comparar con la última entrada
+    std::vector<std::vector<ProfileEntry>> profiles(connections.stop_count());
+    std::vector<int> trip_arrival(connections.trip_count(), NO_SERVICE_TIME);
+
+    // Llegada más temprana saliendo de stop a partir de time
+    auto evaluate = [&](int stop, int time) {
+        const auto& profile = profiles[stop];
+        auto it = std::upper_bound(profile.begin(), profile.end(), time,
+                                   [](int t, const ProfileEntry& e) { return e.departure_time < t; });
+        return it == profile.begin() ? NO_SERVICE_TIME : std::prev(it)->arrival_time;
+    };
+
+    const size_t first = connections.first_departure(window_start);
+    for (size_t i = connections.connection_count(); i-- > first;) {
+        const Connection& c = connections.connection(i);
+
+        int arrival = c.arrival_stop == target ? c.arrival_time : NO_SERVICE_TIME;
+        arrival = std::min(arrival, trip_arrival[c.trip]);         // seguir en el vehículo
+        arrival = std::min(arrival, evaluate(c.arrival_stop, c.arrival_time)); // transbordar
+        if (arrival == NO_SERVICE_TIME) continue;
+
+        trip_arrival[c.trip] = arrival;
+        auto& profile = profiles[c.departure_stop];
+        if (!profile.empty() && profile.back().arrival_time <= arrival) continue;
+        if (!profile.empty() && profile.back().departure_time == c.departure_time) {
+            profile.back().arrival_time = arrival;
+        } else {
+            profile.push_back({c.departure_time, arrival});
+        }
+    }
+
+    std::vector<ProfileEntry> result;
+    for (auto it = profiles[source].rbegin(); it != profiles[source].rend(); ++it) {
+        if (it->departure_time > window_end) break;
+        result.push_back(*it);
+    }
+    return result;
+}
+
 std::vector<int> TransportAlgorithms::bfs_reachable_nodes(const Graph& graph,
                                                           int start_node,
                                                           int max_depth) {
@@ -91,21 +692,17 @@ std::vector<int> TransportAlgorithms::bfs_reachable_nodes(const Graph& graph,
 std::vector<int> TransportAlgorithms::find_routes_through_stop(
     const std::unordered_map<int, std::vector<int>>& route_stops,
     int stop_id) {
-    std::vector<int> routes;
-    for (const auto& [route_id, stops] : route_stops) {
-        for (int stop : stops) {
-            if (stop == stop_id) {
-                routes.push_back(route_id);
-                break;
-            }
-        }
-    }
-    return routes;
+    return find_routes_through_stop(StopRouteIndex(route_stops), stop_id);
+}
+
+std::vector<int> TransportAlgorithms::find_routes_through_stop(
+    const StopRouteIndex& index,
+    int stop_id) {
+    return index.routes_through(stop_id);
 }
 
 double TransportAlgorithms::calculate_distance(double lat1, double lon1,
                                                double lat2, double lon2) {
-    const double PI = std::acos(-1);
     double lat1_rad = lat1 * PI / 180.0;
     double lon1_rad = lon1 * PI / 180.0;
     double lat2_rad = lat2 * PI / 180.0;
@@ -0,0 +1,410 @@
+#include "transport/gtfs_importer.h"
+#include "infra/csv_reader.h"
+#include "infra/db.h"
+#include "infra/logger.h"
+#include "transport/time_columns.h"
+#include "core/service_time.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace urban_transport;
+
+namespace {
+
+constexpr size_t DEFAULT_BATCH_SIZE = 50000;
+
+struct TripState {
+    int id;
+    int route_id;
+    int start = NO_SERVICE_TIME;
+    int end = NO_SERVICE_TIME;
+};
+
+struct StopTime {
+    int sequence;
+    int stop_id;
+    int time;
+};
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && text.front() == ' ') text.remove_prefix(1);
+    while (!text.empty() && text.back() == ' ') text.remove_suffix(1);
+    return text;
+}
+
+std::string_view field_at(const std::vector<std::string_view>& fields, int column) {
+    if (column < 0 || static_cast<size_t>(column) >= fields.size()) return {};
+    return trim(fields[column]);
+}
+
+template <typename T>
+bool parse_number(std::string_view text, T& value) {
+    if (text.empty()) return false;
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+// Tipo del esquema para un route_type de GTFS, básico o extendido
+const char* transport_type_for(int route_type) {
+    switch (route_type) {
+    case 0: case 5: return "tram";
+    case 1: return "metro";
+    case 2: case 7: case 12: return "train";
+    default: break;
+    }
+    if (route_type >= 100 && route_type < 200) return "train";
+    if (route_type >= 400 && route_type < 500) return "metro";
+    if (route_type >= 900 && route_type < 1000) return "tram";
+    return "bus";
+}
+
+std::string time_text(int seconds) {
+    return seconds == NO_SERVICE_TIME ? std::string() : format_service_time(seconds);
+}
+
+} // namespace
+
+class GtfsImporter::Impl {
+public:
+    bool initialize(const std::string& db_path) {
+        if (!db_.connect(db_path)) return false;
+        // Una traza por fila costaría más que la propia inserción
+        db_.set_statement_logging(false);
+        return true;
+    }
+
+    void set_batch_size(size_t rows) {
+        batch_size_ = std::max<size_t>(rows, 1);
+    }
+
+    GtfsImportReport import_directory(const std::string& directory) {
+        GtfsImportReport report;
+        reset();
+        if (!migrate_time_columns(db_)) {
+            report.error = "El esquema no admite horas en segundos (faltan trips/trip_stops)";
+            Logger::get_instance().error("GTFS: " + report.error);
+            return report;
+        }
+
+        using Step = bool (Impl::*)(CsvReader&, GtfsFileStats&, std::string&);
+        const std::pair<const char*, Step> steps[] = {
+            {"stops.txt", &Impl::import_stops},
+            {"routes.txt", &Impl::import_routes},
+            {"trips.txt", &Impl::import_trips},
+            {"stop_times.txt", &Impl::import_stop_times},
+        };
+
+        for (const auto& [file, step] : steps) {
+            CsvReader reader;
+            if (!reader.open(directory + "/" + file)) {
+                report.error = std::string("No se puede abrir ") + file;
+                Logger::get_instance().error("GTFS: " + report.error);
+                return report;
+            }
+
+            GtfsFileStats stats;
+            stats.file = file;
+            stats.bytes = reader.size();
+            auto started = std::chrono::steady_clock::now();
+
+            std::string error;
+            bool ok = begin_batch() && (this->*step)(reader, stats, error) && db_.commit_transaction();
+            if (!ok) db_.rollback_transaction();
+
+            stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+            report.files.push_back(stats);
+            log_throughput(stats);
+
+            if (!ok) {
+                report.error = std::string(file) + ": " + (error.empty() ? "error de escritura" : error);
+                Logger::get_instance().error("GTFS: " + report.error);
+                return report;
+            }
+        }
+
+        report.success = true;
+        return report;
+    }
+
+private:
+    Database db_;
+    size_t batch_size_ = DEFAULT_BATCH_SIZE;
+    size_t pending_rows_ = 0;
+
+    std::unordered_map<std::string, int> stop_ids_;
+    std::unordered_map<std::string, int> route_ids_;
+    std::unordered_map<std::string, size_t> trip_index_;
+    std::vector<TripState> trips_;
+    std::unordered_set<int> routes_with_pattern_;
+    std::vector<std::pair<int, int>> pattern_trips_; // (ruta, viaje que da su secuencia)
+    int next_stop_id_ = 1;
+    int next_route_id_ = 1;
+    int next_trip_id_ = 1;
+
+    void reset() {
+        stop_ids_.clear();
+        route_ids_.clear();
+        trip_index_.clear();
+        trips_.clear();
+        routes_with_pattern_.clear();
+        pattern_trips_.clear();
+        next_stop_id_ = max_id("stops") + 1;
+        next_route_id_ = max_id("routes") + 1;
+        next_trip_id_ = max_id("trips") + 1;
+    }
+
+    int max_id(const std::string& table) const {
+        int id = 0;
+        db_.query_rows("SELECT COALESCE(MAX(id), 0) FROM " + table, [&](const RowView& row) {
+            id = row.get_int(0);
+            return false;
+        });
+        return id;
+    }
+
+    bool begin_batch() {
+        pending_rows_ = 0;
+        return db_.begin_transaction();
+    }
+
+    // Confirma cada batch_size filas para acotar el tamaño de la transacción
+    bool row_written() {
+        if (++pending_rows_ < batch_size_) return true;
+        pending_rows_ = 0;
+        return db_.commit_transaction() && db_.begin_transaction();
+    }
+
+    static bool require_columns(const CsvReader& reader, std::initializer_list<const char*> columns,
+                                std::string& error) {
+        for (const char* column : columns) {
+            if (reader.column(column) < 0) {
+                error = std::string("falta la columna ") + column;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool import_stops(CsvReader& reader, GtfsFileStats& stats, std::string& error) {
+        if (!require_columns(reader, {"stop_id", "stop_name", "stop_lat", "stop_lon"}, error)) return false;
+        int id_column = reader.column("stop_id");
+        int name_column = reader.column("stop_name");
+        int lat_column = reader.column("stop_lat");
+        int lon_column = reader.column("stop_lon");
+
+        std::string sql = "INSERT INTO stops (id, name, latitude, longitude) VALUES (?, ?, ?, ?)";
+        std::vector<std::string_view> fields;
+        while (reader.next(fields)) {
+            std::string_view key = field_at(fields, id_column);
+            double latitude = 0.0;
+            double longitude = 0.0;
+            if (key.empty() || !parse_number(field_at(fields, lat_column), latitude) ||
+                !parse_number(field_at(fields, lon_column), longitude) ||
+                !stop_ids_.emplace(std::string(key), next_stop_id_).second) {
+                ++stats.skipped;
+                continue;
+            }
+            if (!db_.execute_with_values(sql, {next_stop_id_, field_at(fields, name_column), latitude, longitude}) ||
+                !row_written()) {
+                return false;
+            }
+            ++next_stop_id_;
+            ++stats.rows;
+        }
+        return true;
+    }
+
+    bool import_routes(CsvReader& reader, GtfsFileStats& stats, std::string& error) {
+        if (!require_columns(reader, {"route_id", "route_type"}, error)) return false;
+        int id_column = reader.column("route_id");
+        int short_name_column = reader.column("route_short_name");
+        int long_name_column = reader.column("route_long_name");
+        int type_column = reader.column("route_type");
+
+        std::string sql = "INSERT INTO routes (id, name, transport_type) VALUES (?, ?, ?)";
+        std::vector<std::string_view> fields;
+        while (reader.next(fields)) {
+            std::string_view key = field_at(fields, id_column);
+            if (key.empty() || !route_ids_.emplace(std::string(key), next_route_id_).second) {
+                ++stats.skipped;
+                continue;
+            }
+            std::string_view name = field_at(fields, short_name_column);
+            if (name.empty()) name = field_at(fields, long_name_column);
+            if (name.empty()) name = key;
+            int route_type = 3;
+            parse_number(field_at(fields, type_column), route_type);
+
+            if (!db_.execute_with_values(sql, {next_route_id_, name, transport_type_for(route_type)}) ||
+                !row_written()) {
+                return false;
+            }
+            ++next_route_id_;
+            ++stats.rows;
+        }
+        return true;
+    }
+
+    bool import_trips(CsvReader& reader, GtfsFileStats& stats, std::string& error) {
+        if (!require_columns(reader, {"trip_id", "route_id"}, error)) return false;
+        int id_column = reader.column("trip_id");
+        int route_column = reader.column("route_id");
+
+        // Las horas se conocen al leer stop_times.txt
+        std::string sql = "INSERT INTO trips (id, route_id, start_time, end_time) VALUES (?, ?, '', '')";
+        std::vector<std::string_view> fields;
+        while (reader.next(fields)) {
+            std::string_view key = field_at(fields, id_column);
+            auto route = route_ids_.find(std::string(field_at(fields, route_column)));
+            if (key.empty() || route == route_ids_.end() ||
+                !trip_index_.emplace(std::string(key), trips_.size()).second) {
+                ++stats.skipped;
+                continue;
+            }
+            trips_.push_back({next_trip_id_, route->second});
+            if (!db_.execute_with_values(sql, {next_trip_id_, route->second}) || !row_written()) return false;
+            ++next_trip_id_;
+            ++stats.rows;
+        }
+        return true;
+    }
+
+    bool import_stop_times(CsvReader& reader, GtfsFileStats& stats, std::string& error) {
+        if (!require_columns(reader, {"trip_id", "stop_id", "stop_sequence"}, error)) return false;
+        int trip_column = reader.column("trip_id");
+        int stop_column = reader.column("stop_id");
+        int sequence_column = reader.column("stop_sequence");
+        int arrival_column = reader.column("arrival_time");
+        int departure_column = reader.column("departure_time");
+
+        // Las filas de un viaje suelen ir seguidas: se agrupan y se escriben
+        // juntas, buscando el viaje en el mapa solo cuando cambia. GTFS no
+        // lo exige: un viaje partido se escribe en varios grupos, y por eso
+        // las secuencias de las rutas se sacan al final de trip_stops
+        std::string current_key;
+        size_t current_trip = trips_.size();
+        std::vector<StopTime> group;
+        std::vector<std::string_view> fields;
+        while (reader.next(fields)) {
+            std::string_view key = field_at(fields, trip_column);
+            if (current_trip == trips_.size() || key != current_key) {
+                if (current_trip != trips_.size() && !flush_trip(current_trip, group)) return false;
+                group.clear();
+                current_key.assign(key.data(), key.size());
+                auto trip = trip_index_.find(current_key);
+                current_trip = trip == trip_index_.end() ? trips_.size() : trip->second;
+            }
+
+            auto stop = stop_ids_.find(std::string(field_at(fields, stop_column)));
+            int sequence = 0;
+            if (current_trip == trips_.size() || stop == stop_ids_.end() ||
+                !parse_number(field_at(fields, sequence_column), sequence)) {
+                ++stats.skipped;
+                continue;
+            }
+            // Paradas sin hora (no son puntos de control) se guardan vacías
+            int time = NO_SERVICE_TIME;
+            if (!parse_service_time(field_at(fields, arrival_column), time) &&
+                !parse_service_time(field_at(fields, departure_column), time)) {
+                time = NO_SERVICE_TIME;
+            }
+            group.push_back({sequence, stop->second, time});
+            ++stats.rows;
+        }
+        if (current_trip != trips_.size() && !flush_trip(current_trip, group)) return false;
+        if (!write_route_patterns()) return false;
+
+        std::string sql =
+            "UPDATE trips SET start_time = ?, end_time = ?, start_seconds = ?, end_seconds = ? WHERE id = ?";
+        for (const auto& trip : trips_) {
+            if (trip.start == NO_SERVICE_TIME) continue;
+            std::string start = time_text(trip.start);
+            std::string end = time_text(trip.end);
+            if (!db_.execute_with_values(sql, {start, end, trip.start, trip.end, trip.id}) ||
+                !row_written()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Escribe un grupo de paradas de un viaje y, si es el primero de su
+    // ruta, lo apunta para la secuencia de la ruta. Una parada repetida en
+    // el viaje se ignora.
+    bool flush_trip(size_t index, std::vector<StopTime>& group) {
+        if (group.empty()) return true;
+        std::stable_sort(group.begin(), group.end(),
+                         [](const StopTime& a, const StopTime& b) { return a.sequence < b.sequence; });
+
+        TripState& trip = trips_[index];
+        std::string sql =
+            "INSERT OR IGNORE INTO trip_stops (trip_id, stop_id, arrival_time, arrival_seconds, sequence) "
+            "VALUES (?, ?, ?, ?, ?)";
+        for (const auto& stop_time : group) {
+            SqlParam seconds = stop_time.time == NO_SERVICE_TIME ? SqlParam(nullptr) : SqlParam(stop_time.time);
+            std::string arrival = time_text(stop_time.time);
+            if (!db_.execute_with_values(sql, {trip.id, stop_time.stop_id, arrival, seconds, stop_time.sequence}) ||
+                !row_written()) {
+                return false;
+            }
+            if (stop_time.time == NO_SERVICE_TIME) continue;
+            if (trip.start == NO_SERVICE_TIME || stop_time.time < trip.start) trip.start = stop_time.time;
+            if (trip.end == NO_SERVICE_TIME || stop_time.time > trip.end) trip.end = stop_time.time;
+        }
+
+        if (routes_with_pattern_.insert(trip.route_id).second) pattern_trips_.emplace_back(trip.route_id, trip.id);
+        return true;
+    }
+
+    // route_stops de cada ruta con las paradas completas de su primer viaje,
+    // ya escritas en trip_stops aunque vinieran en varios grupos
+    bool write_route_patterns() {
+        std::string stops_sql = "SELECT stop_id FROM trip_stops WHERE trip_id = ? ORDER BY sequence";
+        std::string route_sql = "INSERT OR IGNORE INTO route_stops (route_id, stop_id, sequence) VALUES (?, ?, ?)";
+        std::vector<int> stop_ids;
+        for (const auto& [route_id, trip_id] : pattern_trips_) {
+            stop_ids.clear();
+            if (!db_.query_rows(stops_sql, {trip_id}, [&](const RowView& row) {
+                    stop_ids.push_back(row.get_int(0));
+                    return true;
+                })) {
+                return false;
+            }
+            for (size_t i = 0; i < stop_ids.size(); ++i) {
+                if (!db_.execute_with_values(route_sql, {route_id, stop_ids[i], i + 1}) || !row_written()) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    static void log_throughput(const GtfsFileStats& stats) {
+        char buffer[160];
+        double megabytes = stats.bytes / (1024.0 * 1024.0);
+        std::snprintf(buffer, sizeof(buffer), "%zu filas (%zu descartadas) en %.2f s, %.0f filas/s, %.1f MB/s",
+                      stats.rows, stats.skipped, stats.seconds, stats.rows_per_second(),
+                      stats.seconds > 0.0 ? megabytes / stats.seconds : 0.0);
+        Logger::get_instance().info("GTFS " + stats.file + ": " + buffer);
+    }
+};
+
+// Implementación de GtfsImporter
+GtfsImporter::GtfsImporter() : pimpl(std::make_unique<Impl>()) {}
+GtfsImporter::~GtfsImporter() = default;
+
+bool GtfsImporter::initialize(const std::string& db_path) {
+    return pimpl->initialize(db_path);
+}
+
+void GtfsImporter::set_batch_size(size_t rows) {
+    pimpl->set_batch_size(rows);
+}
+
+GtfsImportReport GtfsImporter::import_directory(const std::string& directory) {
+    return pimpl->import_directory(directory);
+}
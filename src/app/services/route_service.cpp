@@ -1,7 +1,10 @@
 #include "transport/route_service.h"
 #include "infra/db.h"
 #include "infra/logger.h"
+#include "core/entity_store.h"
 #include <memory>
+#include <algorithm>
+#include <unordered_map>
 
 using namespace urban_transport;
 
@@ -13,128 +16,151 @@ public:
     
     bool create_route(const Route& route) {
         std::string sql = "INSERT INTO routes (id, name, transport_type) VALUES (?, ?, ?)";
-        std::vector<std::string> params = {
-            std::to_string(route.id),
-            route.name,
-            route.transport_type
-        };
-        
-        bool result = db_.execute_with_params(sql, params);
+        bool result = db_.execute_with_values(sql, {route.id, route.name, route.transport_type});
         if (result) {
+            // La fila se crea sin paradas
+            Route created = route;
+            created.stop_ids.clear();
+            routes_.upsert(created);
             Logger::get_instance().info("Ruta creada: " + route.name);
         }
         return result;
     }
     
-    Route get_route(int id) const {
-        std::string sql = "SELECT id, name, transport_type FROM routes WHERE id = ?";
-        std::vector<std::string> params = {std::to_string(id)};
-        
-        Route route(0, "", "");
-        db_.query_with_params(sql, params, [&](const std::vector<std::string>& row) {
-            route.id = std::stoi(row[0]);
-            route.name = row[1];
-            route.transport_type = row[2];
-            return false;
+    bool create_routes_with_stops(const std::vector<Route>& routes) {
+        std::string route_sql = "INSERT INTO routes (id, name, transport_type) VALUES (?, ?, ?)";
+        std::string stop_sql = "INSERT INTO route_stops (route_id, stop_id, sequence) VALUES (?, ?, ?)";
+        bool result = db_.run_in_transaction([&] {
+            for (const auto& route : routes) {
+                if (!db_.execute_with_values(route_sql, {route.id, route.name, route.transport_type})) {
+                    return false;
+                }
+                for (size_t i = 0; i < route.stop_ids.size(); ++i) {
+                    if (!db_.execute_with_values(stop_sql, {route.id, route.stop_ids[i], i + 1})) return false;
+                }
+            }
+            return true;
         });
-        
-        route.stop_ids = get_route_stops(id);
-        return route;
+        if (result) {
+            for (const auto& route : routes) routes_.upsert(route);
+            Logger::get_instance().info("Rutas creadas: " + std::to_string(routes.size()));
+        }
+        return result;
+    }
+    
+    Route get_route(int id) const {
+        auto route = routes_.find(id);
+        return route ? *route : Route(0, "", "");
     }
     
     std::vector<Route> get_all_routes() const {
-        std::vector<Route> routes;
-        std::string sql = "SELECT id, name, transport_type FROM routes ORDER BY id";
-        
-        db_.query(sql, [&](const std::vector<std::string>& row) {
-            Route route(std::stoi(row[0]), row[1], row[2]);
-            route.stop_ids = get_route_stops(route.id);
-            routes.push_back(route);
-            return true;
-        });
-        
-        return routes;
+        return routes_.all();
     }
     
     bool update_route(const Route& route) {
         std::string sql = "UPDATE routes SET name = ?, transport_type = ? WHERE id = ?";
-        std::vector<std::string> params = {
-            route.name,
-            route.transport_type,
-            std::to_string(route.id)
-        };
-        
-        return db_.execute_with_params(sql, params);
+        bool result = db_.execute_with_values(sql, {route.name, route.transport_type, route.id});
+        if (result) {
+            // Las paradas no cambian con el UPDATE
+            routes_.update(route.id, [&](Route& cached) {
+                cached.name = route.name;
+                cached.transport_type = route.transport_type;
+            });
+        }
+        return result;
     }
     
     bool delete_route(int id) {
         // Primero eliminar las relaciones con paradas
         std::string sql1 = "DELETE FROM route_stops WHERE route_id = ?";
-        std::vector<std::string> params1 = {std::to_string(id)};
-        db_.execute_with_params(sql1, params1);
+        db_.execute_with_values(sql1, {id});
         
         // Luego eliminar la ruta
         std::string sql2 = "DELETE FROM routes WHERE id = ?";
-        std::vector<std::string> params2 = {std::to_string(id)};
-        
-        return db_.execute_with_params(sql2, params2);
+        bool result = db_.execute_with_values(sql2, {id});
+        if (result) routes_.erase(id);
+        return result;
     }
     
     std::vector<Route> find_routes_by_type(const std::string& transport_type) const {
-        std::vector<Route> routes;
-        std::string sql = "SELECT id, name, transport_type FROM routes WHERE transport_type = ?";
-        std::vector<std::string> params = {transport_type};
-        
-        db_.query_with_params(sql, params, [&](const std::vector<std::string>& row) {
-            Route route(std::stoi(row[0]), row[1], row[2]);
-            route.stop_ids = get_route_stops(route.id);
-            routes.push_back(route);
-            return true;
-        });
-        
-        return routes;
+        return routes_.filter([&](const Route& route) { return route.transport_type == transport_type; });
     }
     
     std::vector<int> get_route_stops(int route_id) const {
+        auto route = routes_.find(route_id);
+        if (route) return route->stop_ids;
+
+        // route_stops no exige que la ruta exista: filas sin ruta, desde SQLite
         std::vector<int> stops;
         std::string sql = "SELECT stop_id FROM route_stops WHERE route_id = ? ORDER BY sequence";
-        std::vector<std::string> params = {std::to_string(route_id)};
-        
-        db_.query_with_params(sql, params, [&](const std::vector<std::string>& row) {
-            stops.push_back(std::stoi(row[0]));
+        db_.query_rows(sql, {route_id}, [&](const RowView& row) {
+            stops.push_back(row.get_int(0));
             return true;
         });
-        
         return stops;
     }
     
     bool add_stop_to_route(int route_id, int stop_id) {
-        // Obtener siguiente secuencia
-        auto stops = get_route_stops(route_id);
-        int sequence = stops.size() + 1;
-        
-        std::string sql = "INSERT INTO route_stops (route_id, stop_id, sequence) VALUES (?, ?, ?)";
-        std::vector<std::string> params = {
-            std::to_string(route_id),
-            std::to_string(stop_id),
-            std::to_string(sequence)
-        };
-        
-        return db_.execute_with_params(sql, params);
+        // Siguiente secuencia calculada en la misma sentencia; MAX y no el
+        // número de paradas, que se repetiría tras quitar una
+        std::string sql =
+            "INSERT INTO route_stops (route_id, stop_id, sequence) "
+            "SELECT ?1, ?2, COALESCE(MAX(sequence), 0) + 1 FROM route_stops WHERE route_id = ?1";
+        bool result = db_.execute_with_values(sql, {route_id, stop_id});
+        if (result) routes_.update(route_id, [&](Route& cached) { cached.stop_ids.push_back(stop_id); });
+        return result;
     }
     
     bool remove_stop_from_route(int route_id, int stop_id) {
         std::string sql = "DELETE FROM route_stops WHERE route_id = ? AND stop_id = ?";
-        std::vector<std::string> params = {
-            std::to_string(route_id),
-            std::to_string(stop_id)
-        };
-        
-        return db_.execute_with_params(sql, params);
+        bool result = db_.execute_with_values(sql, {route_id, stop_id});
+        if (result) {
+            routes_.update(route_id, [&](Route& cached) {
+                auto& stops = cached.stop_ids;
+                stops.erase(std::remove(stops.begin(), stops.end(), stop_id), stops.end());
+            });
+        }
+        return result;
+    }
+
+    EntityStoreStats cache_stats() const {
+        return routes_.stats();
+    }
+
+    void invalidate_cache() {
+        routes_.invalidate();
     }
 
 private:
     Database db_;
+
+    // Copia en memoria de routes con sus paradas, cargada en la primera lectura
+    EntityStore<Route> routes_{[this] { return load_routes(); }};
+
+    // Dos consultas para toda la tabla: rutas y route_stops en orden de
+    // secuencia, repartidas en una sola pasada
+    std::vector<Route> load_routes() const {
+        std::vector<Route> routes;
+        std::unordered_map<int, size_t> positions;
+        db_.query_rows("SELECT id, name, transport_type FROM routes ORDER BY id", [&](const RowView& row) {
+            positions.emplace(row.get_int(0), routes.size());
+            routes.push_back(read_route(row));
+            return true;
+        });
+
+        db_.query_rows("SELECT route_id, stop_id FROM route_stops ORDER BY route_id, sequence",
+                       [&](const RowView& row) {
+            auto it = positions.find(row.get_int(0));
+            if (it != positions.end()) routes[it->second].stop_ids.push_back(row.get_int(1));
+            return true;
+        });
+        return routes;
+    }
+
+    // Fila (id, name, transport_type)
+    static Route read_route(const RowView& row) {
+        return Route(row.get_int(0), std::string(row.get_text(1)), std::string(row.get_text(2)));
+    }
 };
 
 // Implementación de RouteService
@@ -149,6 +175,10 @@ bool RouteService::create_route(const Route& route) {
     return pimpl->create_route(route);
 }
 
+bool RouteService::create_routes_with_stops(const std::vector<Route>& routes) {
+    return pimpl->create_routes_with_stops(routes);
+}
+
 Route RouteService::get_route(int id) const {
     return pimpl->get_route(id);
 }
@@ -169,6 +199,14 @@ std::vector<Route> RouteService::find_routes_by_type(const std::string& transpor
     return pimpl->find_routes_by_type(transport_type);
 }
 
+EntityStoreStats RouteService::cache_stats() const {
+    return pimpl->cache_stats();
+}
+
+void RouteService::invalidate_cache() {
+    pimpl->invalidate_cache();
+}
+
 std::vector<int> RouteService::get_route_stops(int route_id) const {
     return pimpl->get_route_stops(route_id);
 }
@@ -2,7 +2,11 @@
 #include "infra/db.h"
 #include "infra/logger.h"
 #include "core/algorithms.h"
+#include "core/spatial_index.h"
+#include "core/entity_store.h"
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <cmath>
 
 using namespace urban_transport;
@@ -15,88 +19,87 @@ public:
     
     bool create_stop(const Stop& stop) {
         std::string sql = "INSERT INTO stops (id, name, latitude, longitude) VALUES (?, ?, ?, ?)";
-        std::vector<std::string> params = {
-            std::to_string(stop.id),
-            stop.name,
-            std::to_string(stop.latitude),
-            std::to_string(stop.longitude)
-        };
-        
-        bool result = db_.execute_with_params(sql, params);
+        bool result = db_.execute_with_values(sql, {stop.id, stop.name, stop.latitude, stop.longitude});
         if (result) {
+            stops_.upsert(stop);
+            index_stop(stop);
             Logger::get_instance().info("Parada creada: " + stop.name);
         }
         return result;
     }
     
-    Stop get_stop(int id) const {
-        std::string sql = "SELECT id, name, latitude, longitude FROM stops WHERE id = ?";
-        std::vector<std::string> params = {std::to_string(id)};
-        
-        Stop stop(0, "", 0, 0);
-        db_.query_with_params(sql, params, [&](const std::vector<std::string>& row) {
-            stop.id = std::stoi(row[0]);
-            stop.name = row[1];
-            stop.latitude = std::stod(row[2]);
-            stop.longitude = std::stod(row[3]);
-            return false;
+    bool create_stops(const std::vector<Stop>& stops) {
+        std::string sql = "INSERT INTO stops (id, name, latitude, longitude) VALUES (?, ?, ?, ?)";
+        bool result = db_.run_in_transaction([&] {
+            for (const auto& stop : stops) {
+                if (!db_.execute_with_values(sql, {stop.id, stop.name, stop.latitude, stop.longitude})) {
+                    return false;
+                }
+            }
+            return true;
         });
-        
-        return stop;
+        if (result) {
+            for (const auto& stop : stops) {
+                stops_.upsert(stop);
+                index_stop(stop);
+            }
+            Logger::get_instance().info("Paradas creadas: " + std::to_string(stops.size()));
+        }
+        return result;
+    }
+    
+    Stop get_stop(int id) const {
+        auto stop = stops_.find(id);
+        return stop ? *stop : Stop(0, "", 0, 0);
     }
     
     std::vector<Stop> get_all_stops() const {
-        std::vector<Stop> stops;
-        std::string sql = "SELECT id, name, latitude, longitude FROM stops ORDER BY id";
-        
-        db_.query(sql, [&](const std::vector<std::string>& row) {
-            stops.emplace_back(
-                std::stoi(row[0]),
-                row[1],
-                std::stod(row[2]),
-                std::stod(row[3])
-            );
-            return true;
-        });
-        
-        return stops;
+        return stops_.all();
     }
     
     bool update_stop(const Stop& stop) {
         std::string sql = "UPDATE stops SET name = ?, latitude = ?, longitude = ? WHERE id = ?";
-        std::vector<std::string> params = {
-            stop.name,
-            std::to_string(stop.latitude),
-            std::to_string(stop.longitude),
-            std::to_string(stop.id)
-        };
-        
-        return db_.execute_with_params(sql, params);
+        bool result = db_.execute_with_values(sql, {stop.name, stop.latitude, stop.longitude, stop.id});
+        // Un UPDATE sin filas afectadas no debe dar de alta la parada
+        if (result) {
+            stops_.replace(stop);
+            index_stop(stop, true);
+        }
+        return result;
     }
     
     bool delete_stop(int id) {
         std::string sql = "DELETE FROM stops WHERE id = ?";
-        std::vector<std::string> params = {std::to_string(id)};
-        
-        return db_.execute_with_params(sql, params);
+        bool result = db_.execute_with_values(sql, {id});
+        if (result) {
+            stops_.erase(id);
+            std::lock_guard<std::mutex> lock(spatial_mutex_);
+            if (spatial_ready_) spatial_index_.remove(id);
+        }
+        return result;
     }
     
     std::vector<Stop> find_nearby_stops(double latitude, double longitude, double radius_km) const {
-        std::vector<Stop> nearby_stops;
-        auto all_stops = get_all_stops();
-        
-        for (const auto& stop : all_stops) {
-            double distance = TransportAlgorithms::calculate_distance(
-                latitude, longitude,
-                stop.latitude, stop.longitude
-            );
-            
-            if (distance <= radius_km) {
-                nearby_stops.push_back(stop);
-            }
-        }
-        
-        return nearby_stops;
+        std::lock_guard<std::mutex> lock(spatial_mutex_);
+        ensure_spatial_index();
+        return to_stops(spatial_index_.within_radius(latitude, longitude, radius_km));
+    }
+
+    std::vector<Stop> find_nearest_stops(double latitude, double longitude, size_t count) const {
+        std::lock_guard<std::mutex> lock(spatial_mutex_);
+        ensure_spatial_index();
+        return to_stops(spatial_index_.nearest(latitude, longitude, count));
+    }
+    
+    EntityStoreStats cache_stats() const {
+        return stops_.stats();
+    }
+
+    void invalidate_cache() {
+        stops_.invalidate();
+        std::lock_guard<std::mutex> lock(spatial_mutex_);
+        spatial_index_.clear();
+        spatial_ready_ = false;
     }
     
     std::vector<Route> get_routes_through_stop(int stop_id) const {
@@ -107,10 +110,8 @@ public:
             "JOIN route_stops rs ON r.id = rs.route_id "
             "WHERE rs.stop_id = ?";
         
-        std::vector<std::string> params = {std::to_string(stop_id)};
-        
-        db_.query_with_params(sql, params, [&](const std::vector<std::string>& row) {
-            Route route(std::stoi(row[0]), row[1], row[2]);
+        db_.query_rows(sql, {stop_id}, [&](const RowView& row) {
+            Route route(row.get_int(0), std::string(row.get_text(1)), std::string(row.get_text(2)));
             // Obtener paradas de la ruta
             route.stop_ids = get_route_stops(route.id);
             routes.push_back(route);
@@ -122,14 +123,60 @@ public:
 
 private:
     Database db_;
+
+    // Fila (id, name, latitude, longitude)
+    static Stop read_stop(const RowView& row) {
+        return Stop(row.get_int(0), std::string(row.get_text(1)), row.get_double(2), row.get_double(3));
+    }
+
+    // Copia en memoria de la tabla stops, cargada en la primera lectura
+    EntityStore<Stop> stops_{[this] { return load_stops(); }};
+
+    std::vector<Stop> load_stops() const {
+        std::vector<Stop> stops;
+        db_.query_rows("SELECT id, name, latitude, longitude FROM stops ORDER BY id", [&](const RowView& row) {
+            stops.push_back(read_stop(row));
+            return true;
+        });
+        return stops;
+    }
+
+    // Índice espacial sobre las paradas del almacén, cargado en la primera
+    // consulta y mantenido después por create/update/delete
+    mutable std::mutex spatial_mutex_;
+    mutable bool spatial_ready_ = false;
+    mutable SpatialIndex spatial_index_;
+
+    void ensure_spatial_index() const {
+        if (spatial_ready_) return;
+        for (const auto& stop : stops_.all()) {
+            spatial_index_.insert(stop.id, stop.latitude, stop.longitude);
+        }
+        spatial_ready_ = true;
+    }
+
+    void index_stop(const Stop& stop, bool existing_only = false) {
+        std::lock_guard<std::mutex> lock(spatial_mutex_);
+        if (!spatial_ready_) return; // se cargará completo en la primera consulta
+        if (!spatial_index_.remove(stop.id) && existing_only) return;
+        spatial_index_.insert(stop.id, stop.latitude, stop.longitude);
+    }
+
+    std::vector<Stop> to_stops(const std::vector<SpatialMatch>& matches) const {
+        std::vector<Stop> stops;
+        stops.reserve(matches.size());
+        for (const auto& match : matches) {
+            if (auto stop = stops_.find(match.id)) stops.push_back(std::move(*stop));
+        }
+        return stops;
+    }
     
     std::vector<int> get_route_stops(int route_id) const {
         std::vector<int> stops;
         std::string sql = "SELECT stop_id FROM route_stops WHERE route_id = ? ORDER BY sequence";
-        std::vector<std::string> params = {std::to_string(route_id)};
         
-        db_.query_with_params(sql, params, [&](const std::vector<std::string>& row) {
-            stops.push_back(std::stoi(row[0]));
+        db_.query_rows(sql, {route_id}, [&](const RowView& row) {
+            stops.push_back(row.get_int(0));
             return true;
         });
         
@@ -149,6 +196,10 @@ bool StopService::create_stop(const Stop& stop) {
     return pimpl->create_stop(stop);
 }
 
+bool StopService::create_stops(const std::vector<Stop>& stops) {
+    return pimpl->create_stops(stops);
+}
+
 Stop StopService::get_stop(int id) const {
     return pimpl->get_stop(id);
 }
@@ -169,6 +220,18 @@ std::vector<Stop> StopService::find_nearby_stops(double latitude, double longitu
     return pimpl->find_nearby_stops(latitude, longitude, radius_km);
 }
 
+std::vector<Stop> StopService::find_nearest_stops(double latitude, double longitude, size_t count) const {
+    return pimpl->find_nearest_stops(latitude, longitude, count);
+}
+
+EntityStoreStats StopService::cache_stats() const {
+    return pimpl->cache_stats();
+}
+
+void StopService::invalidate_cache() {
+    pimpl->invalidate_cache();
+}
+
 std::vector<Route> StopService::get_routes_through_stop(int stop_id) const {
     return pimpl->get_routes_through_stop(stop_id);
 }
\ No newline at end of file
@@ -1,7 +1,12 @@
 #include "transport/trip_service.h"
 #include "infra/db.h"
 #include "infra/logger.h"
+#include "core/entity_store.h"
+#include "core/trip_interval_index.h"
+#include "core/departure_board.h"
+#include "transport/time_columns.h"
 #include <memory>
+#include <mutex>
 
 using namespace urban_transport;
 
@@ -12,138 +17,374 @@ public:
     }
 
     bool create_trip(const Trip& trip) {
-        std::string sql = "INSERT INTO trips (id, route_id, start_time, end_time) VALUES (?, ?, ?, ?)";
-        std::vector<std::string> params = {
-            std::to_string(trip.id),
-            std::to_string(trip.route_id),
-            trip.start_time,
-            trip.end_time
-        };
-
-        bool result = db_.execute_with_params(sql, params);
+        if (!ensure_time_columns()) return false;
+        bool result = db_.execute_with_values(TRIP_INSERT_SQL, trip_values(trip));
         if (result) {
+            // La fila se crea sin paradas
+            Trip created = trip;
+            created.stop_sequence.clear();
+            trips_.upsert(created);
+            index_trip(trip);
             Logger::get_instance().info("Trip created: id=" + std::to_string(trip.id));
         }
         return result;
     }
 
-    Trip get_trip(int id) const {
-        std::string sql = "SELECT id, route_id, start_time, end_time FROM trips WHERE id = ?";
-        std::vector<std::string> params = {std::to_string(id)};
-
-        Trip trip(0, 0, "", "");
-        db_.query_with_params(sql, params, [&](const std::vector<std::string>& row) {
-            trip.id = std::stoi(row[0]);
-            trip.route_id = std::stoi(row[1]);
-            trip.start_time = row[2];
-            trip.end_time = row[3];
-            return false; // detener después de la primera fila
+    bool create_trips_with_stop_times(const std::vector<TripSchedule>& schedules) {
+        for (const auto& schedule : schedules) {
+            if (schedule.arrival_times.size() != schedule.trip.stop_sequence.size()) {
+                Logger::get_instance().error("Trip " + std::to_string(schedule.trip.id) +
+                                             " has mismatched stop times");
+                return false;
+            }
+        }
+
+        if (!ensure_time_columns()) return false;
+        std::string stop_sql =
+            "INSERT INTO trip_stops (trip_id, stop_id, arrival_time, arrival_seconds, sequence) "
+            "VALUES (?, ?, ?, ?, ?)";
+        bool result = db_.run_in_transaction([&] {
+            for (const auto& schedule : schedules) {
+                const Trip& trip = schedule.trip;
+                if (!db_.execute_with_values(TRIP_INSERT_SQL, trip_values(trip))) return false;
+                for (size_t i = 0; i < trip.stop_sequence.size(); ++i) {
+                    const std::string& arrival = schedule.arrival_times[i];
+                    if (!db_.execute_with_values(stop_sql, {trip.id, trip.stop_sequence[i], arrival,
+                                                            service_seconds_param(arrival), i + 1})) {
+                        return false;
+                    }
+                }
+            }
+            return true;
         });
+        if (result) {
+            for (const auto& schedule : schedules) {
+                trips_.upsert(schedule.trip);
+                index_trip(schedule.trip);
+                board_schedule(schedule);
+            }
+            Logger::get_instance().info("Trips created: " + std::to_string(schedules.size()));
+        }
+        return result;
+    }
 
-        trip.stop_sequence = get_trip_stops(id);
-        return trip;
+    Trip get_trip(int id) const {
+        auto trip = trips_.find(id);
+        return trip ? *trip : Trip(0, 0, "", "");
     }
 
     std::vector<Trip> get_all_trips() const {
-        std::vector<Trip> trips;
-        std::string sql = "SELECT id, route_id, start_time, end_time FROM trips ORDER BY id";
-
-        db_.query(sql, [&](const std::vector<std::string>& row) {
-            Trip trip(std::stoi(row[0]), std::stoi(row[1]), row[2], row[3]);
-            trip.stop_sequence = get_trip_stops(trip.id);
-            trips.push_back(trip);
-            return true;
-        });
-
-        return trips;
+        return trips_.all();
     }
 
     bool update_trip(const Trip& trip) {
-        std::string sql = "UPDATE trips SET route_id = ?, start_time = ?, end_time = ? WHERE id = ?";
-        std::vector<std::string> params = {
-            std::to_string(trip.route_id),
-            trip.start_time,
-            trip.end_time,
-            std::to_string(trip.id)
-        };
-
-        return db_.execute_with_params(sql, params);
+        if (!ensure_time_columns()) return false;
+        std::string sql =
+            "UPDATE trips SET route_id = ?, start_time = ?, end_time = ?, start_seconds = ?, end_seconds = ? "
+            "WHERE id = ?";
+        bool result = db_.execute_with_values(sql, {trip.route_id, trip.start_time, trip.end_time,
+                                                    service_seconds_param(trip.start_time),
+                                                    service_seconds_param(trip.end_time), trip.id});
+        if (result) {
+            // Un UPDATE sin filas afectadas no debe dar de alta el viaje
+            if (trips_.find(trip.id)) {
+                index_trip(trip);
+                std::lock_guard<std::mutex> lock(board_mutex_);
+                if (board_ready_) board_.set_trip_route(trip.id, trip.route_id);
+            }
+            // Las paradas no cambian con el UPDATE
+            trips_.update(trip.id, [&](Trip& cached) {
+                cached.route_id = trip.route_id;
+                cached.start_time = trip.start_time;
+                cached.end_time = trip.end_time;
+            });
+        }
+        return result;
     }
 
     bool delete_trip(int id) {
         // eliminar relaciones con paradas
         std::string sql1 = "DELETE FROM trip_stops WHERE trip_id = ?";
-        std::vector<std::string> params1 = {std::to_string(id)};
-        db_.execute_with_params(sql1, params1);
+        db_.execute_with_values(sql1, {id});
 
         std::string sql2 = "DELETE FROM trips WHERE id = ?";
-        std::vector<std::string> params2 = {std::to_string(id)};
-        return db_.execute_with_params(sql2, params2);
+        bool result = db_.execute_with_values(sql2, {id});
+        if (result) {
+            trips_.erase(id);
+            {
+                std::lock_guard<std::mutex> lock(intervals_mutex_);
+                if (intervals_ready_) intervals_.remove(id);
+            }
+            std::lock_guard<std::mutex> lock(board_mutex_);
+            if (board_ready_) board_.remove_trip(id);
+        }
+        return result;
     }
 
     std::vector<Trip> find_trips_by_route(int route_id) const {
-        std::vector<Trip> trips;
-        std::string sql = "SELECT id, route_id, start_time, end_time FROM trips WHERE route_id = ? ORDER BY id";
-        std::vector<std::string> params = {std::to_string(route_id)};
+        return load_trips("WHERE t.route_id = ?", "t.id", {route_id});
+    }
 
-        db_.query_with_params(sql, params, [&](const std::vector<std::string>& row) {
-            Trip trip(std::stoi(row[0]), std::stoi(row[1]), row[2], row[3]);
-            trip.stop_sequence = get_trip_stops(trip.id);
-            trips.push_back(trip);
-            return true;
+    std::vector<Trip> find_trips_by_time_range(const std::string& start_time, const std::string& end_time) {
+        return find_by_window(start_time, end_time,
+                              [](const TripIntervalIndex& index, int from, int until) {
+            return index.within(from, until);
         });
+    }
 
-        return trips;
+    std::vector<Trip> find_trips_active_between(const std::string& start_time, const std::string& end_time) {
+        return find_by_window(start_time, end_time,
+                              [](const TripIntervalIndex& index, int from, int until) {
+            return index.active_between(from, until);
+        });
     }
 
-    std::vector<Trip> find_trips_by_time_range(const std::string& start_time, const std::string& end_time) const {
-        std::vector<Trip> trips;
-        std::string sql = "SELECT id, route_id, start_time, end_time FROM trips WHERE start_time >= ? AND end_time <= ? ORDER BY start_time";
-        std::vector<std::string> params = {start_time, end_time};
+    // arrival_time vacía: hora desconocida, la parada no sale en el panel
+    bool add_stop_to_trip(int trip_id, int stop_id, int sequence, const std::string& arrival_time) {
+        if (!ensure_time_columns()) return false;
+        bool result = false;
+        if (sequence <= 0) {
+            // al final: MAX(sequence) + 1 en la misma sentencia
+            std::string sql =
+                "INSERT INTO trip_stops (trip_id, stop_id, arrival_time, arrival_seconds, sequence) "
+                "SELECT ?1, ?2, ?3, ?4, COALESCE(MAX(sequence), 0) + 1 FROM trip_stops WHERE trip_id = ?1";
+            result = db_.execute_with_values(sql, {trip_id, stop_id, arrival_time,
+                                                   service_seconds_param(arrival_time)});
+        } else {
+            std::string sql =
+                "INSERT INTO trip_stops (trip_id, stop_id, arrival_time, arrival_seconds, sequence) "
+                "VALUES (?, ?, ?, ?, ?)";
+            result = db_.execute_with_values(sql, {trip_id, stop_id, arrival_time,
+                                                   service_seconds_param(arrival_time), sequence});
+        }
+        if (result) {
+            // La secuencia explícita puede caer en medio: se relee la del viaje
+            std::vector<int> stops = query_trip_stops(trip_id);
+            trips_.update(trip_id, [&](Trip& cached) { cached.stop_sequence = std::move(stops); });
+
+            int time = 0;
+            auto trip = trips_.find(trip_id);
+            if (trip && parse_service_time(arrival_time, time)) {
+                std::lock_guard<std::mutex> lock(board_mutex_);
+                if (board_ready_) board_.add(stop_id, time, trip_id, trip->route_id);
+            }
+        }
+        return result;
+    }
+
+    std::vector<Departure> next_departures(int stop_id, const std::string& after, size_t count) {
+        int from = 0;
+        if (!parse_service_time(after, from)) {
+            Logger::get_instance().error("Invalid departure time: " + after);
+            return {};
+        }
+        if (!ensure_time_columns()) return {};
+        std::lock_guard<std::mutex> lock(board_mutex_);
+        ensure_board();
+        return board_.next_departures(stop_id, from, count);
+    }
+
+    std::vector<RouteDepartures> next_departures_by_route(int stop_id, const std::string& after,
+                                                          const std::string& until, size_t per_route) {
+        int from = 0;
+        int to = 0;
+        if (!parse_service_time(after, from) || !parse_service_time(until, to)) {
+            Logger::get_instance().error("Invalid departure window: " + after + " - " + until);
+            return {};
+        }
+        if (!ensure_time_columns()) return {};
+        std::lock_guard<std::mutex> lock(board_mutex_);
+        ensure_board();
+        return board_.next_departures_by_route(stop_id, from, to - from, per_route);
+    }
+
+    std::vector<int> get_trip_stops(int trip_id) const {
+        auto trip = trips_.find(trip_id);
+        // trip_stops no exige que el viaje exista: filas sin viaje, desde SQLite
+        return trip ? trip->stop_sequence : query_trip_stops(trip_id);
+    }
+
+    EntityStoreStats cache_stats() const {
+        return trips_.stats();
+    }
+
+    void invalidate_cache() {
+        trips_.invalidate();
+        std::lock_guard<std::mutex> lock(intervals_mutex_);
+        intervals_ = TripIntervalIndex();
+        intervals_ready_ = false;
+        std::lock_guard<std::mutex> board_lock(board_mutex_);
+        board_ = DepartureBoard();
+        board_ready_ = false;
+    }
+
+private:
+    Database db_;
+
+    static constexpr const char* TRIP_INSERT_SQL =
+        "INSERT INTO trips (id, route_id, start_time, end_time, start_seconds, end_seconds) "
+        "VALUES (?, ?, ?, ?, ?, ?)";
+
+    static std::vector<SqlParam> trip_values(const Trip& trip) {
+        return {trip.id, trip.route_id, trip.start_time, trip.end_time,
+                service_seconds_param(trip.start_time), service_seconds_param(trip.end_time)};
+    }
+
+    // Las columnas *_seconds se añaden en el primer uso, cuando las tablas ya
+    // existen; después basta con consultar el indicador
+    std::mutex migration_mutex_;
+    bool time_columns_ready_ = false;
+
+    bool ensure_time_columns() {
+        std::lock_guard<std::mutex> lock(migration_mutex_);
+        if (!time_columns_ready_) time_columns_ready_ = migrate_time_columns(db_);
+        return time_columns_ready_;
+    }
 
-        db_.query_with_params(sql, params, [&](const std::vector<std::string>& row) {
-            Trip trip(std::stoi(row[0]), std::stoi(row[1]), row[2], row[3]);
-            trip.stop_sequence = get_trip_stops(trip.id);
-            trips.push_back(trip);
+    // Intervalos de servicio de los viajes con horas válidas, cargados en la
+    // primera consulta por franja y mantenidos por create/update/delete
+    mutable std::mutex intervals_mutex_;
+    mutable bool intervals_ready_ = false;
+    mutable TripIntervalIndex intervals_;
+
+    // Carga desde las columnas enteras; la consulta se resuelve con el
+    // índice de cobertura idx_trips_service_time
+    void ensure_intervals() const {
+        if (intervals_ready_) return;
+        std::vector<TripInterval> intervals;
+        db_.query_rows("SELECT id, start_seconds, end_seconds FROM trips "
+                       "WHERE start_seconds IS NOT NULL AND end_seconds IS NOT NULL",
+                       [&](const RowView& row) {
+            intervals.push_back({row.get_int(0), row.get_int(1), row.get_int(2)});
             return true;
         });
+        intervals_ = TripIntervalIndex(std::move(intervals));
+        intervals_ready_ = true;
+    }
 
-        return trips;
+    void index_trip(const Trip& trip) {
+        std::lock_guard<std::mutex> lock(intervals_mutex_);
+        if (!intervals_ready_) return; // se cargará completo en la primera consulta
+        int start = 0;
+        int end = 0;
+        if (parse_service_time(trip.start_time, start) && parse_service_time(trip.end_time, end)) {
+            intervals_.insert(trip.id, start, end);
+        } else {
+            intervals_.remove(trip.id);
+        }
     }
 
-    bool add_stop_to_trip(int trip_id, int stop_id, int sequence) {
-        // if sequence <= 0, append to end
-        if (sequence <= 0) {
-            auto stops = get_trip_stops(trip_id);
-            sequence = static_cast<int>(stops.size()) + 1;
+    // Panel de salidas por parada, cargado en la primera consulta y mantenido
+    // por create_trips_with_stop_times, add_stop_to_trip, update_trip y
+    // delete_trip; las consultas no tocan SQLite
+    std::mutex board_mutex_;
+    bool board_ready_ = false;
+    DepartureBoard board_;
+
+    // Lectura por el índice idx_trip_stops_stop_time; las filas llegan
+    // ordenadas por parada y hora, así que cada alta va al final del array
+    void ensure_board() {
+        if (board_ready_) return;
+        db_.query_rows("SELECT ts.stop_id, ts.arrival_seconds, ts.trip_id, t.route_id "
+                       "FROM trip_stops ts "
+                       "JOIN trips t ON t.id = ts.trip_id "
+                       "WHERE ts.arrival_seconds IS NOT NULL "
+                       "ORDER BY ts.stop_id, ts.arrival_seconds",
+                       [&](const RowView& row) {
+            board_.add(row.get_int(0), row.get_int(1), row.get_int(2), row.get_int(3));
+            return true;
+        });
+        board_ready_ = true;
+    }
+
+    void board_schedule(const TripSchedule& schedule) {
+        std::lock_guard<std::mutex> lock(board_mutex_);
+        if (!board_ready_) return; // se cargará completo en la primera consulta
+        const Trip& trip = schedule.trip;
+        for (size_t i = 0; i < trip.stop_sequence.size(); ++i) {
+            int time = 0;
+            if (parse_service_time(schedule.arrival_times[i], time)) {
+                board_.add(trip.stop_sequence[i], time, trip.id, trip.route_id);
+            }
         }
+    }
 
-        std::string sql = "INSERT INTO trip_stops (trip_id, stop_id, arrival_time, sequence) VALUES (?, ?, ?, ?)";
-        std::vector<std::string> params = {
-            std::to_string(trip_id),
-            std::to_string(stop_id),
-            std::string(""), // arrival_time unknown
-            std::to_string(sequence)
-        };
+    template <typename Query>
+    std::vector<Trip> find_by_window(const std::string& start_time, const std::string& end_time,
+                                     Query query) {
+        int from = 0;
+        int until = 0;
+        if (!parse_service_time(start_time, from) || !parse_service_time(end_time, until)) {
+            Logger::get_instance().error("Invalid time window: " + start_time + " - " + end_time);
+            return {};
+        }
+        if (!ensure_time_columns()) return {};
 
-        return db_.execute_with_params(sql, params);
+        std::vector<int> trip_ids;
+        {
+            std::lock_guard<std::mutex> lock(intervals_mutex_);
+            ensure_intervals();
+            trip_ids = query(intervals_, from, until);
+        }
+        std::vector<Trip> trips;
+        trips.reserve(trip_ids.size());
+        for (int trip_id : trip_ids) {
+            if (auto trip = trips_.find(trip_id)) trips.push_back(std::move(*trip));
+        }
+        return trips;
     }
 
-    std::vector<int> get_trip_stops(int trip_id) const {
+    // Copia en memoria de trips con sus paradas, cargada en la primera lectura
+    EntityStore<Trip> trips_{[this] { return load_trips("", "t.id", {}); }};
+
+    // Viajes filtrados por where (sobre el alias t) con sus paradas, en una
+    // sola consulta ordenada: las filas de cada viaje llegan seguidas y en
+    // orden de secuencia, así que stop_sequence se arma en una pasada. Un
+    // COUNT previo con el mismo filtro reserva el vector de viajes, y cada
+    // viaje reserva las paradas del anterior (suelen ser de la misma ruta).
+    std::vector<Trip> load_trips(const std::string& where, const std::string& order_by,
+                                 const std::vector<SqlParam>& params) const {
+        std::vector<Trip> trips;
+        db_.query_rows("SELECT COUNT(*) FROM trips t " + where, params, [&](const RowView& row) {
+            trips.reserve(static_cast<size_t>(row.get_int64(0)));
+            return false;
+        });
+
+        std::string sql =
+            "SELECT t.id, t.route_id, t.start_time, t.end_time, ts.stop_id "
+            "FROM trips t "
+            "LEFT JOIN trip_stops ts ON ts.trip_id = t.id " +
+            where + " ORDER BY " + order_by + ", ts.sequence";
+        db_.query_rows(sql, params, [&](const RowView& row) {
+            int trip_id = row.get_int(0);
+            if (trips.empty() || trips.back().id != trip_id) {
+                size_t expected = trips.empty() ? 0 : trips.back().stop_sequence.size();
+                trips.push_back(read_trip(row));
+                trips.back().stop_sequence.reserve(expected);
+            }
+            // Viaje sin paradas: una sola fila con stop_id NULL
+            if (!row.is_null(4)) trips.back().stop_sequence.push_back(row.get_int(4));
+            return true;
+        });
+        return trips;
+    }
+
+    std::vector<int> query_trip_stops(int trip_id) const {
         std::vector<int> stops;
         std::string sql = "SELECT stop_id FROM trip_stops WHERE trip_id = ? ORDER BY sequence";
-        std::vector<std::string> params = {std::to_string(trip_id)};
 
-        db_.query_with_params(sql, params, [&](const std::vector<std::string>& row) {
-            stops.push_back(std::stoi(row[0]));
+        db_.query_rows(sql, {trip_id}, [&](const RowView& row) {
+            stops.push_back(row.get_int(0));
             return true;
         });
 
         return stops;
     }
 
-private:
-    Database db_;
+    // Fila (id, route_id, start_time, end_time)
+    static Trip read_trip(const RowView& row) {
+        return Trip(row.get_int(0), row.get_int(1), std::string(row.get_text(2)), std::string(row.get_text(3)));
+    }
 };
 
 // Implementación de TripService
@@ -158,6 +399,10 @@ bool TripService::create_trip(const Trip& trip) {
     return pimpl->create_trip(trip);
 }
 
+bool TripService::create_trips_with_stop_times(const std::vector<TripSchedule>& schedules) {
+    return pimpl->create_trips_with_stop_times(schedules);
+}
+
 Trip TripService::get_trip(int id) const {
     return pimpl->get_trip(id);
 }
@@ -182,8 +427,39 @@ std::vector<Trip> TripService::find_trips_by_time_range(const std::string& start
     return pimpl->find_trips_by_time_range(start_time, end_time);
 }
 
+std::vector<Trip> TripService::find_trips_active_between(const std::string& start_time,
+                                                        const std::string& end_time) const {
+    return pimpl->find_trips_active_between(start_time, end_time);
+}
+
+std::vector<Trip> TripService::find_trips_active_at(const std::string& time) const {
+    return pimpl->find_trips_active_between(time, time);
+}
+
 bool TripService::add_stop_to_trip(int trip_id, int stop_id, int sequence) {
-    return pimpl->add_stop_to_trip(trip_id, stop_id, sequence);
+    return pimpl->add_stop_to_trip(trip_id, stop_id, sequence, "");
+}
+
+bool TripService::add_stop_to_trip(int trip_id, int stop_id, int sequence, const std::string& arrival_time) {
+    return pimpl->add_stop_to_trip(trip_id, stop_id, sequence, arrival_time);
+}
+
+std::vector<Departure> TripService::next_departures(int stop_id, const std::string& after, size_t count) const {
+    return pimpl->next_departures(stop_id, after, count);
+}
+
+std::vector<RouteDepartures> TripService::next_departures_by_route(int stop_id, const std::string& after,
+                                                                  const std::string& until,
+                                                                  size_t per_route) const {
+    return pimpl->next_departures_by_route(stop_id, after, until, per_route);
+}
+
+EntityStoreStats TripService::cache_stats() const {
+    return pimpl->cache_stats();
+}
+
+void TripService::invalidate_cache() {
+    pimpl->invalidate_cache();
 }
 
 std::vector<int> TripService::get_trip_stops(int trip_id) const {
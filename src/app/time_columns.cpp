@@ -0,0 +1,80 @@
+#include "transport/time_columns.h"
+#include "infra/logger.h"
+#include "core/service_time.h"
+#include <vector>
+#include <utility>
+
+using namespace urban_transport;
+
+namespace {
+
+bool has_table(const Database& db, const char* table) {
+    bool found = false;
+    db.query_rows("SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = ?", {table},
+                  [&](const RowView&) {
+        found = true;
+        return false;
+    });
+    return found;
+}
+
+bool has_column(const Database& db, const std::string& table, std::string_view column) {
+    bool found = false;
+    db.query_rows("PRAGMA table_info(" + table + ")", [&](const RowView& row) {
+        found = row.get_text(1) == column;
+        return !found;
+    });
+    return found;
+}
+
+// Rellena column a partir de la hora en texto de las filas que aún no la
+// tienen; las horas vacías o inválidas se quedan en NULL
+bool fill_seconds(Database& db, const std::string& table, const std::string& text_column,
+                  const std::string& seconds_column) {
+    std::vector<std::pair<int64_t, int>> values;
+    db.query_rows("SELECT rowid, " + text_column + " FROM " + table + " WHERE " + seconds_column +
+                  " IS NULL AND " + text_column + " <> ''", [&](const RowView& row) {
+        int seconds = 0;
+        if (parse_service_time(row.get_text(1), seconds)) values.emplace_back(row.get_int64(0), seconds);
+        return true;
+    });
+
+    std::string sql = "UPDATE " + table + " SET " + seconds_column + " = ? WHERE rowid = ?";
+    for (const auto& [rowid, seconds] : values) {
+        if (!db.execute_with_values(sql, {seconds, rowid})) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool urban_transport::migrate_time_columns(Database& db) {
+    if (!has_table(db, "trips") || !has_table(db, "trip_stops")) return false;
+
+    bool result = db.run_in_transaction([&] {
+        const std::pair<const char*, const char*> columns[] = {
+            {"trips", "start_seconds"}, {"trips", "end_seconds"}, {"trip_stops", "arrival_seconds"}};
+        for (const auto& [table, column] : columns) {
+            if (has_column(db, table, column)) continue;
+            if (!db.execute(std::string("ALTER TABLE ") + table + " ADD COLUMN " + column + " INTEGER")) {
+                return false;
+            }
+        }
+
+        return fill_seconds(db, "trips", "start_time", "start_seconds") &&
+               fill_seconds(db, "trips", "end_time", "end_seconds") &&
+               fill_seconds(db, "trip_stops", "arrival_time", "arrival_seconds") &&
+               db.execute("CREATE INDEX IF NOT EXISTS idx_trips_service_time "
+                          "ON trips(start_seconds, end_seconds, id)") &&
+               db.execute("CREATE INDEX IF NOT EXISTS idx_trip_stops_stop_time "
+                          "ON trip_stops(stop_id, arrival_seconds, trip_id)");
+    });
+    if (!result) Logger::get_instance().error("Failed to migrate trip time columns");
+    return result;
+}
+
+SqlParam urban_transport::service_seconds_param(std::string_view time) {
+    int seconds = 0;
+    if (!parse_service_time(time, seconds)) return SqlParam(nullptr);
+    return SqlParam(seconds);
+}
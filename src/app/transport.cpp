@@ -2,202 +2,587 @@
 #include "infra/db.h"
 #include "infra/logger.h"
 #include "core/algorithms.h"
+#include "core/contraction_hierarchy.h"
+#include "core/landmarks.h"
+#include "core/network_snapshot.h"
+#include "core/stop_route_index.h"
+#include "core/entity_store.h"
 #include <memory>
+#include <atomic>
+#include <mutex>
+#include <limits>
 #include <unordered_map>
 
 using namespace urban_transport;
 
+namespace {
+
+// Metadatos de las rutas más el índice invertido parada -> rutas.
+// Las Route del mapa no llevan stop_ids: las secuencias viven en el índice.
+struct RouteCatalog {
+    std::unordered_map<int, Route> routes;
+    StopRouteIndex index;
+
+    Route route_with_stops(int route_id) const {
+        Route route = routes.at(route_id);
+        route.stop_ids = index.route_stops(route_id);
+        return route;
+    }
+};
+
+// Estructuras de enrutamiento inmutables (estilo RCU). Un escritor construye
+// o parchea una versión nueva y la publica con un atomic_store del
+// shared_ptr; las consultas fijan la actual con atomic_load sin tomar ningún
+// mutex. Nadie modifica una versión publicada, y la anterior se libera
+// cuando la suelta el último lector que la tenía fijada.
+struct RoutingSnapshot {
+    CsrGraph graph;
+    std::shared_ptr<const ContractionHierarchy> hierarchy;
+    std::shared_ptr<const LandmarkIndex> landmarks;
+    std::shared_ptr<const Timetable> timetable;
+    std::shared_ptr<const ConnectionTable> connections;
+    std::shared_ptr<const RouteCatalog> catalog;
+    RoutingAlgorithm algorithm = RoutingAlgorithm::BIDIRECTIONAL;
+    bool adjusted_weights = false; // algún peso viene de update_edge_weight
+    uint64_t version = 0;
+};
+
+// Cada hilo usa su propio workspace (thread_local) sobre la instantánea
+std::vector<int> route_on(const RoutingSnapshot& snapshot, int start_stop, int end_stop) {
+    switch (snapshot.algorithm) {
+    case RoutingAlgorithm::DIJKSTRA:
+        return TransportAlgorithms::dijkstra_shortest_path(snapshot.graph, start_stop, end_stop);
+    case RoutingAlgorithm::ASTAR:
+        return TransportAlgorithms::astar_shortest_path(snapshot.graph, start_stop, end_stop);
+    case RoutingAlgorithm::CONTRACTION_HIERARCHY:
+        return snapshot.hierarchy->shortest_path(start_stop, end_stop);
+    case RoutingAlgorithm::LANDMARKS:
+        return TransportAlgorithms::alt_shortest_path(snapshot.graph, *snapshot.landmarks,
+                                                      start_stop, end_stop);
+    case RoutingAlgorithm::BIDIRECTIONAL:
+    default:
+        return TransportAlgorithms::bidirectional_dijkstra(snapshot.graph, start_stop, end_stop);
+    }
+}
+
+} // namespace
+
 class TransportSystem::Impl {
 public:
-    bool initialize(const std::string& db_path) {
-        if (!db_.connect(db_path)) {
-            Logger::get_instance().error("Failed to connect to database");
-            return false;
+    bool initialize(const std::string& db_path, const std::string& snapshot_path = "") {
+        std::lock_guard<std::mutex> writer(writer_mutex_);
+        {
+            std::lock_guard<std::mutex> db(db_mutex_);
+            if (!db_.connect(db_path)) {
+                Logger::get_instance().error("Failed to connect to database");
+                return false;
+            }
         }
+        db_path_ = db_path;
 
-        initialize_graph();
+        // Huella tomada antes de leer la red: si otro proceso escribe mientras
+        // se construye, la instantánea queda como obsoleta y no al revés
+        uint64_t fingerprint = snapshot_path.empty() ? 0 : database_fingerprint(db_path_);
+        bool from_snapshot = !snapshot_path.empty() && load_network_snapshot(snapshot_path, fingerprint);
+        if (!from_snapshot) initialize_graph();
+        load_timetables();
+        rebuild_routing_structures();
+        query_pool_ = std::make_unique<ThreadPool>();
+
+        if (!snapshot_path.empty() && !from_snapshot) {
+            if (write_snapshot(snapshot_path, fingerprint)) {
+                Logger::get_instance().info("Network snapshot written to " + snapshot_path);
+            } else {
+                Logger::get_instance().warning("Failed to write network snapshot " + snapshot_path);
+            }
+        }
 
         Logger::get_instance().info("Transport system initialized");
         return true;
     }
     
     void shutdown() {
+        std::lock_guard<std::mutex> db(db_mutex_);
         db_.disconnect();
         Logger::get_instance().info("Transport system shutdown");
     }
     
     bool add_stop(const Stop& stop) {
+        std::lock_guard<std::mutex> writer(writer_mutex_);
         std::string sql = "INSERT INTO stops (id, name, latitude, longitude) VALUES (?, ?, ?, ?)";
-        std::vector<std::string> params = {
-            std::to_string(stop.id),
-            stop.name,
-            std::to_string(stop.latitude),
-            std::to_string(stop.longitude)
-        };
-        
-        bool result = db_.execute_with_params(sql, params);
+        bool result;
+        {
+            std::lock_guard<std::mutex> db(db_mutex_);
+            result = db_.execute_with_values(sql, {stop.id, stop.name, stop.latitude, stop.longitude});
+        }
         if (result) {
-            graph_.add_node(stop.id);
+            stops_.upsert(stop);
+            materialize_graph();
+            graph_.set_coordinates(stop.id, stop.latitude, stop.longitude);
+            rebuild_routing_structures();
             Logger::get_instance().info("Stop added: " + stop.name);
         }
         return result;
     }
     
     Stop get_stop(int id) const {
-        std::string sql = "SELECT id, name, latitude, longitude FROM stops WHERE id = ?";
-        std::vector<std::string> params = {std::to_string(id)};
-        
-        Stop stop(0, "", 0, 0);
-        db_.query_with_params(sql, params, [&](const std::vector<std::string>& row) {
-            stop.id = std::stoi(row[0]);
-            stop.name = row[1];
-            stop.latitude = std::stod(row[2]);
-            stop.longitude = std::stod(row[3]);
-            return false; // Solo primera fila
-        });
-        
-        return stop;
+        auto stop = stops_.find(id);
+        return stop ? *stop : Stop(0, "", 0, 0);
     }
     
     std::vector<Stop> get_all_stops() const {
-        std::vector<Stop> stops;
-        std::string sql = "SELECT id, name, latitude, longitude FROM stops ORDER BY id";
-        
-        db_.query(sql, [&](const std::vector<std::string>& row) {
-            stops.emplace_back(
-                std::stoi(row[0]),
-                row[1],
-                std::stod(row[2]),
-                std::stod(row[3])
-            );
-            return true;
-        });
-        
-        return stops;
+        return stops_.all();
     }
     
     bool add_route(const Route& route) {
-        std::string sql = "INSERT INTO routes (id, name, transport_type) VALUES (?, ?, ?)";
-        std::vector<std::string> params = {
-            std::to_string(route.id),
-            route.name,
-            route.transport_type
-        };
-        
-        bool result = db_.execute_with_params(sql, params);
+        std::lock_guard<std::mutex> writer(writer_mutex_);
+        // Ruta y paradas en una sola transacción, con secuencias explícitas
+        std::string route_sql = "INSERT INTO routes (id, name, transport_type) VALUES (?, ?, ?)";
+        std::string stop_sql = "INSERT INTO route_stops (route_id, stop_id, sequence) VALUES (?, ?, ?)";
+        bool result;
+        {
+            std::lock_guard<std::mutex> db(db_mutex_);
+            result = db_.run_in_transaction([&] {
+                if (!db_.execute_with_values(route_sql, {route.id, route.name, route.transport_type})) return false;
+                for (size_t i = 0; i < route.stop_ids.size(); ++i) {
+                    if (!db_.execute_with_values(stop_sql, {route.id, route.stop_ids[i], i + 1})) return false;
+                }
+                return true;
+            });
+        }
         if (result) {
-            for (int stop_id : route.stop_ids) add_stop_to_route(route.id, stop_id);
+            routes_.upsert(route);
+            remember_route(route);
+            rebuild_route_catalog();
+            auto next = std::make_shared<RoutingSnapshot>(*pin_snapshot());
+            next->catalog = catalog_;
+            publish_snapshot(std::move(next));
             Logger::get_instance().info("Route added: " + route.name);
         }
         return result;
     }
     
     Route get_route(int id) const {
-        std::string sql = "SELECT id, name, transport_type FROM routes WHERE id = ?";
-        std::vector<std::string> params = {std::to_string(id)};
-        
-        Route route(0, "", "");
-        db_.query_with_params(sql, params, [&](const std::vector<std::string>& row) {
-            route.id = std::stoi(row[0]);
-            route.name = row[1];
-            route.transport_type = row[2];
-            return false;
-        });
-        
-        // Obtener paradas de la ruta
-        route.stop_ids = get_route_stops(id);
-        
-        return route;
+        auto route = routes_.find(id);
+        return route ? *route : Route(0, "", "");
     }
     
     std::vector<Route> get_all_routes() const {
-        std::vector<Route> routes;
-        std::string sql = "SELECT id, name, transport_type FROM routes ORDER BY id";
-        
-        db_.query(sql, [&](const std::vector<std::string>& row) {
-            Route route(std::stoi(row[0]), row[1], row[2]);
-            route.stop_ids = get_route_stops(route.id);
-            routes.push_back(route);
-            return true;
-        });
-        
-        return routes;
+        return routes_.all();
+    }
+
+    EntityCacheStats entity_cache_stats() const {
+        return {stops_.stats(), routes_.stats()};
+    }
+
+    void invalidate_entity_cache() {
+        stops_.invalidate();
+        routes_.invalidate();
     }
     
     std::vector<int> find_shortest_path(int start_stop, int end_stop) const {
-        return TransportAlgorithms::dijkstra_shortest_path(graph_, start_stop, end_stop);
+        return route_on(*pin_snapshot(), start_stop, end_stop);
+    }
+
+    std::vector<std::vector<int>> find_shortest_paths(
+        const std::vector<std::pair<int, int>>& queries) const {
+        std::vector<std::vector<int>> paths(queries.size());
+        // Todo el lote se resuelve sobre la misma instantánea
+        auto snapshot = pin_snapshot();
+        if (!query_pool_) {
+            for (size_t i = 0; i < queries.size(); ++i) {
+                paths[i] = route_on(*snapshot, queries[i].first, queries[i].second);
+            }
+            return paths;
+        }
+        query_pool_->parallel_for(queries.size(), [&](size_t i, size_t) {
+            paths[i] = route_on(*snapshot, queries[i].first, queries[i].second);
+        });
+        return paths;
+    }
+
+    void set_routing_algorithm(RoutingAlgorithm algorithm) {
+        std::lock_guard<std::mutex> writer(writer_mutex_);
+        if (algorithm == routing_algorithm_) return;
+        routing_algorithm_ = algorithm;
+        rebuild_routing_structures();
+    }
+
+    void set_landmark_count(size_t count) {
+        std::lock_guard<std::mutex> writer(writer_mutex_);
+        landmark_count_ = count;
+        if (routing_algorithm_ == RoutingAlgorithm::LANDMARKS) rebuild_routing_structures();
+    }
+
+    bool update_edge_weight(int from_stop, int to_stop, double weight) {
+        std::lock_guard<std::mutex> writer(writer_mutex_);
+        materialize_graph();
+        double previous = 0.0;
+        bool found = false;
+        for (const auto& edge : graph_.get_edges(from_stop)) {
+            if (edge.target == to_stop) {
+                previous = edge.weight;
+                found = true;
+            }
+        }
+        if (!found || !graph_.set_edge_weight(from_stop, to_stop, weight)) return false;
+        adjusted_weights_ = true;
+
+        // Si el peso solo sube, las cotas de los landmarks siguen siendo válidas
+        rebuild_routing_structures(weight >= previous);
+        return true;
+    }
+
+    std::vector<std::pair<int, double>> reachable_within(int stop_id, double max_distance) const {
+        auto snapshot = pin_snapshot();
+        std::vector<std::pair<int, double>> result;
+        for (const auto& stop : TransportAlgorithms::isochrone(snapshot->graph, stop_id, max_distance)) {
+            result.emplace_back(stop.stop_id, stop.cost);
+        }
+        return result;
+    }
+
+    Journey earliest_arrival(int start_stop, int end_stop, const std::string& departure_time,
+                             int max_transfers) const {
+        int departure = 0;
+        if (!parse_service_time(departure_time, departure)) {
+            Logger::get_instance().error("Invalid departure time: " + departure_time);
+            return Journey();
+        }
+        auto snapshot = pin_snapshot();
+        if (!snapshot->timetable) return Journey();
+        return TransportAlgorithms::raptor_earliest_arrival(*snapshot->timetable, start_stop, end_stop,
+                                                            departure, max_transfers);
+    }
+
+    std::vector<ProfileEntry> departure_profile(int start_stop, int end_stop,
+                                                const std::string& window_start,
+                                                const std::string& window_end) const {
+        int from = 0;
+        int until = 0;
+        if (!parse_service_time(window_start, from) || !parse_service_time(window_end, until)) {
+            Logger::get_instance().error("Invalid departure window: " + window_start + " - " + window_end);
+            return {};
+        }
+        auto snapshot = pin_snapshot();
+        if (!snapshot->connections) return {};
+        return TransportAlgorithms::csa_profile(*snapshot->connections, start_stop, end_stop, from, until);
+    }
+
+    RoutingAlgorithm routing_algorithm() const {
+        return pin_snapshot()->algorithm;
+    }
+
+    uint64_t network_version() const {
+        return pin_snapshot()->version;
     }
     
+    std::vector<double> distance_matrix(const std::vector<int>& sources,
+                                        const std::vector<int>& targets) const {
+        if (!query_pool_) return std::vector<double>(sources.size() * targets.size(),
+                                                       std::numeric_limits<double>::infinity());
+        auto snapshot = pin_snapshot();
+        return TransportAlgorithms::distance_matrix(snapshot->graph, sources, targets, *query_pool_);
+    }
+
     std::vector<Route> find_routes_through_stop(int stop_id) const {
         std::vector<Route> routes;
-        std::string sql = 
-            "SELECT r.id, r.name, r.transport_type "
-            "FROM routes r "
-            "JOIN route_stops rs ON r.id = rs.route_id "
-            "WHERE rs.stop_id = ?";
-        
-        std::vector<std::string> params = {std::to_string(stop_id)};
-        
-        db_.query_with_params(sql, params, [&](const std::vector<std::string>& row) {
-            Route route(std::stoi(row[0]), row[1], row[2]);
-            route.stop_ids = get_route_stops(route.id);
-            routes.push_back(route);
-            return true;
-        });
-        
+        auto snapshot = pin_snapshot();
+        if (!snapshot->catalog) return routes;
+        for (int route_id : snapshot->catalog->index.routes_through(stop_id)) {
+            routes.push_back(snapshot->catalog->route_with_stops(route_id));
+        }
         return routes;
     }
 
+    std::vector<Route> find_direct_routes(int from_stop, int to_stop) const {
+        std::vector<Route> routes;
+        auto snapshot = pin_snapshot();
+        if (!snapshot->catalog) return routes;
+        for (int route_id : snapshot->catalog->index.direct_routes(from_stop, to_stop)) {
+            routes.push_back(snapshot->catalog->route_with_stops(route_id));
+        }
+        return routes;
+    }
+
+    // Guarda el grafo y las rutas de la instantánea actual con la huella de
+    // la base de datos en este momento
+    bool save_snapshot(const std::string& path) const {
+        return write_snapshot(path, database_fingerprint(db_path_));
+    }
+
 private:
     Database db_;
-    Graph graph_;
+    std::string db_path_;
+    Graph graph_; // solo lo modifican los escritores, bajo writer_mutex_
+    // Tras arrancar desde una instantánea el grafo es una vista sobre el
+    // fichero mapeado; graph_ se rellena en la primera modificación
+    bool graph_mapped_ = false;
+    CsrGraph mapped_graph_;
+    size_t landmark_count_ = 8;
+    RoutingAlgorithm routing_algorithm_ = RoutingAlgorithm::BIDIRECTIONAL;
+    bool adjusted_weights_ = false; // solo se escribe bajo writer_mutex_
+    std::shared_ptr<const Timetable> timetable_;
+    std::shared_ptr<const ConnectionTable> connections_;
+    std::unordered_map<int, Route> route_info_; // rutas sin stop_ids
+    std::shared_ptr<const RouteCatalog> catalog_;
+    std::unique_ptr<ThreadPool> query_pool_;
+
+    // Copias en memoria de stops y routes (con paradas) para las lecturas de
+    // entidades; se cargan en la primera lectura, no al arrancar
+    EntityStore<Stop> stops_{[this] { return load_stops(); }};
+    EntityStore<Route> routes_{[this] { return load_routes(); }};
+
+    std::mutex writer_mutex_; // serializa a los escritores; los lectores no lo usan
+    // Turno sobre db_ (una conexión con sus transacciones y sentencias): lo
+    // toman las escrituras y las cargas de stops_/routes_, que así nunca ven
+    // una transacción a medias. Orden: writer_mutex_, lock de un
+    // EntityStore y db_mutex_; nunca se llama a un EntityStore con él tomado.
+    mutable std::mutex db_mutex_;
+    // Solo se accede con std::atomic_load/atomic_store
+    std::shared_ptr<const RoutingSnapshot> snapshot_ = std::make_shared<RoutingSnapshot>();
+
+    std::shared_ptr<const RoutingSnapshot> pin_snapshot() const {
+        return std::atomic_load_explicit(&snapshot_, std::memory_order_acquire);
+    }
+
+    // Requiere writer_mutex_, que también ordena las versiones
+    void publish_snapshot(std::shared_ptr<RoutingSnapshot> snapshot) {
+        snapshot->version = pin_snapshot()->version + 1;
+        std::atomic_store_explicit(&snapshot_, std::shared_ptr<const RoutingSnapshot>(std::move(snapshot)),
+                                   std::memory_order_release);
+    }
+
+    // Regenera las estructuras de solo lectura tras cambiar graph_ y las
+    // publica como una nueva instantánea. Requiere writer_mutex_.
+    // keep_landmarks conserva las tablas ALT si el conjunto de nodos no cambió.
+    void rebuild_routing_structures(bool keep_landmarks = false) {
+        auto previous = pin_snapshot();
+        auto next = std::make_shared<RoutingSnapshot>();
+        next->graph = graph_mapped_ ? mapped_graph_ : CsrGraph(graph_);
+        next->algorithm = routing_algorithm_;
+        next->adjusted_weights = adjusted_weights_;
+        next->timetable = timetable_;
+        next->connections = connections_;
+        next->catalog = catalog_;
+
+        if (routing_algorithm_ == RoutingAlgorithm::CONTRACTION_HIERARCHY) {
+            next->hierarchy = std::make_shared<ContractionHierarchy>(next->graph);
+            Logger::get_instance().info("Contraction hierarchy built with " +
+                                        std::to_string(next->hierarchy->shortcut_count()) + " shortcuts");
+        }
+
+        if (routing_algorithm_ == RoutingAlgorithm::LANDMARKS) {
+            bool reusable = keep_landmarks && previous->landmarks && !previous->landmarks->empty() &&
+                            previous->landmarks->node_count() == next->graph.node_count();
+            if (reusable) {
+                next->landmarks = previous->landmarks;
+            } else {
+                next->landmarks = std::make_shared<LandmarkIndex>(next->graph, landmark_count_);
+                Logger::get_instance().info("Landmark tables built for " +
+                                            std::to_string(next->landmarks->landmark_count()) + " landmarks");
+            }
+        }
+
+        publish_snapshot(std::move(next));
+    }
     std::unordered_map<int, std::vector<int>> route_stops_;
-    
-    void initialize_graph() {
-        auto stops = get_all_stops();
-        for (const auto& stop : stops) graph_.add_node(stop.id);
-
-        auto routes = get_all_routes();
-        for (const auto& route : routes) {
-            if (route.stop_ids.size() < 2) continue;
-            for (size_t i = 0; i + 1 < route.stop_ids.size(); ++i) {
-                int from = route.stop_ids[i];
-                int to = route.stop_ids[i + 1];
-
-                auto stop1 = get_stop(from);
-                auto stop2 = get_stop(to);
-                double distance = TransportAlgorithms::calculate_distance(
-                    stop1.latitude, stop1.longitude,
-                    stop2.latitude, stop2.longitude);
-
-                graph_.add_edge(from, to, distance);
-                graph_.add_edge(to, from, distance);
+
+    // Escribe la instantánea actual con la huella dada, que debe ser anterior
+    // a la lectura de la red de la base de datos
+    bool write_snapshot(const std::string& path, uint64_t fingerprint) const {
+        auto snapshot = pin_snapshot();
+        std::vector<SnapshotRoute> routes;
+        if (snapshot->catalog) {
+            for (const auto& [id, info] : snapshot->catalog->routes) {
+                routes.push_back({id, info.name, info.transport_type,
+                                  snapshot->catalog->index.route_stops(id)});
+            }
+        }
+        return NetworkSnapshot::write(path, fingerprint, snapshot->graph, routes, snapshot->adjusted_weights);
+    }
+
+    // Red desde la instantánea binaria si existe y corresponde a la base de
+    // datos (huella fingerprint). Requiere writer_mutex_.
+    bool load_network_snapshot(const std::string& path, uint64_t fingerprint) {
+        NetworkSnapshot snapshot;
+        if (!snapshot.open(path, fingerprint)) {
+            Logger::get_instance().info("Network snapshot missing or stale, rebuilding from database");
+            return false;
+        }
+        // Guardada con pesos ajustados: no es la red que describe la base de datos
+        if (snapshot.adjusted_weights()) {
+            Logger::get_instance().info("Network snapshot has adjusted weights, rebuilding from database");
+            return false;
+        }
+
+        mapped_graph_ = snapshot.graph();
+        graph_mapped_ = true;
+        auto catalog = std::make_shared<RouteCatalog>();
+        for (auto& route : snapshot.routes()) {
+            route_stops_[route.id] = route.stop_ids;
+            Route info(route.id, route.name, route.transport_type);
+            route_info_.emplace(route.id, info);
+            catalog->routes.emplace(route.id, info);
+        }
+        catalog->index = snapshot.route_index();
+        catalog_ = std::move(catalog);
+        Logger::get_instance().info("Network loaded from snapshot " + path);
+        return true;
+    }
+
+    // Copia la vista mapeada en graph_ antes de modificarlo. Requiere writer_mutex_.
+    void materialize_graph() {
+        if (!graph_mapped_) return;
+        const CsrGraph& csr = mapped_graph_;
+        const int n = static_cast<int>(csr.node_count());
+        for (int i = 0; i < n; ++i) {
+            graph_.add_node(csr.node_id(i));
+            if (csr.has_coordinates(i)) graph_.set_coordinates(csr.node_id(i), csr.latitude(i), csr.longitude(i));
+        }
+        for (int i = 0; i < n; ++i) {
+            for (uint32_t e = csr.edge_begin(i); e < csr.edge_end(i); ++e) {
+                graph_.add_edge(csr.node_id(i), csr.node_id(csr.edge_target(e)), csr.edge_weight(e));
             }
         }
+        graph_mapped_ = false;
+        mapped_graph_ = CsrGraph();
+    }
+
+    void remember_route(const Route& route) {
+        route_stops_[route.id] = route.stop_ids;
+        Route info = route;
+        info.stop_ids.clear();
+        route_info_.erase(route.id);
+        route_info_.emplace(route.id, info);
+    }
+
+    // Reconstruye el índice parada -> rutas. Requiere writer_mutex_.
+    void rebuild_route_catalog() {
+        auto catalog = std::make_shared<RouteCatalog>();
+        catalog->routes = route_info_;
+        catalog->index = StopRouteIndex(route_stops_);
+        catalog_ = std::move(catalog);
+    }
+
+    // Horario completo en una sola consulta, ordenado por viaje y secuencia.
+    // Los viajes con horas vacías o inválidas se descartan.
+    std::vector<ScheduledTrip> load_scheduled_trips() const {
+        std::lock_guard<std::mutex> db(db_mutex_);
+        std::vector<ScheduledTrip> trips;
+        bool valid = true;
+        std::string sql =
+            "SELECT ts.trip_id, ts.stop_id, ts.arrival_time "
+            "FROM trip_stops ts "
+            "JOIN trips t ON t.id = ts.trip_id "
+            "ORDER BY ts.trip_id, ts.sequence";
+
+        db_.query_rows(sql, [&](const RowView& row) {
+            int trip_id = row.get_int(0);
+            if (trips.empty() || trips.back().trip_id != trip_id) {
+                if (!trips.empty() && !valid) trips.pop_back();
+                trips.push_back({trip_id, {}, {}});
+                valid = true;
+            }
+            int time = 0;
+            if (!parse_service_time(row.get_text(2), time)) valid = false;
+            trips.back().stop_ids.push_back(row.get_int(1));
+            trips.back().times.push_back(time);
+            return true;
+        });
+        if (!trips.empty() && !valid) trips.pop_back();
+        return trips;
+    }
+
+    // Estructuras de horario (RAPTOR y CSA) a partir de la misma carga
+    void load_timetables() {
+        auto trips = load_scheduled_trips();
+        timetable_ = std::make_shared<Timetable>(trips);
+        connections_ = std::make_shared<ConnectionTable>(trips);
+        Logger::get_instance().info("Timetable loaded with " + std::to_string(timetable_->trip_count()) +
+                                    " trips in " + std::to_string(timetable_->route_count()) + " patterns, " +
+                                    std::to_string(connections_->connection_count()) + " connections");
     }
     
-    std::vector<int> get_route_stops(int route_id) const {
-        std::vector<int> stops;
-        std::string sql = "SELECT stop_id FROM route_stops WHERE route_id = ? ORDER BY sequence";
-        std::vector<std::string> params = {std::to_string(route_id)};
-        
-        db_.query_with_params(sql, params, [&](const std::vector<std::string>& row) {
-            stops.push_back(std::stoi(row[0]));
+    // Carga masiva: una consulta por tabla y una sola pasada por las paradas
+    // de las rutas, sin consultas por ruta ni por arista
+    void initialize_graph() {
+        std::lock_guard<std::mutex> db(db_mutex_);
+        db_.query_rows("SELECT id, latitude, longitude FROM stops", [&](const RowView& row) {
+            graph_.set_coordinates(row.get_int(0), row.get_double(1), row.get_double(2));
+            return true;
+        });
+
+        db_.query_rows("SELECT id, name, transport_type FROM routes", [&](const RowView& row) {
+            remember_route(Route(row.get_int(0), std::string(row.get_text(1)), std::string(row.get_text(2))));
+            return true;
+        });
+
+        // Las filas llegan agrupadas por ruta y en orden de secuencia: cada
+        // fila forma una arista con la anterior si pertenece a la misma ruta
+        std::string sql =
+            "SELECT rs.route_id, rs.stop_id, s.latitude, s.longitude "
+            "FROM route_stops rs "
+            "JOIN stops s ON s.id = rs.stop_id "
+            "JOIN routes r ON r.id = rs.route_id "
+            "ORDER BY rs.route_id, rs.sequence";
+
+        int previous_route = -1;
+        int previous_stop = -1;
+        double previous_lat = 0.0;
+        double previous_lon = 0.0;
+        bool has_previous = false;
+        db_.query_rows(sql, [&](const RowView& row) {
+            int route_id = row.get_int(0);
+            int stop_id = row.get_int(1);
+            double lat = row.get_double(2);
+            double lon = row.get_double(3);
+
+            route_stops_[route_id].push_back(stop_id);
+            if (has_previous && previous_route == route_id) {
+                double distance = TransportAlgorithms::calculate_distance(previous_lat, previous_lon, lat, lon);
+                graph_.add_edge(previous_stop, stop_id, distance);
+                graph_.add_edge(stop_id, previous_stop, distance);
+            }
+
+            previous_route = route_id;
+            previous_stop = stop_id;
+            previous_lat = lat;
+            previous_lon = lon;
+            has_previous = true;
+            return true;
+        });
+
+        rebuild_route_catalog();
+    }
+
+    std::vector<Stop> load_stops() const {
+        std::lock_guard<std::mutex> db(db_mutex_);
+        std::vector<Stop> stops;
+        db_.query_rows("SELECT id, name, latitude, longitude FROM stops ORDER BY id", [&](const RowView& row) {
+            stops.emplace_back(row.get_int(0), std::string(row.get_text(1)), row.get_double(2), row.get_double(3));
             return true;
         });
-        
         return stops;
     }
-    
-    bool add_stop_to_route(int route_id, int stop_id) {
-        std::string sql = "INSERT INTO route_stops (route_id, stop_id, sequence) VALUES (?, ?, ?)";
-        std::vector<std::string> params = {
-            std::to_string(route_id),
-            std::to_string(stop_id),
-            std::to_string(get_route_stops(route_id).size() + 1)
-        };
-        
-        return db_.execute_with_params(sql, params);
+
+    // Rutas y route_stops en dos consultas, sin una por ruta
+    std::vector<Route> load_routes() const {
+        std::lock_guard<std::mutex> db(db_mutex_);
+        std::vector<Route> routes;
+        std::unordered_map<int, size_t> positions;
+        db_.query_rows("SELECT id, name, transport_type FROM routes ORDER BY id", [&](const RowView& row) {
+            positions.emplace(row.get_int(0), routes.size());
+            routes.emplace_back(row.get_int(0), std::string(row.get_text(1)), std::string(row.get_text(2)));
+            return true;
+        });
+        db_.query_rows("SELECT route_id, stop_id FROM route_stops ORDER BY route_id, sequence",
+                       [&](const RowView& row) {
+            auto it = positions.find(row.get_int(0));
+            if (it != positions.end()) routes[it->second].stop_ids.push_back(row.get_int(1));
+            return true;
+        });
+        return routes;
     }
 };
 
@@ -209,6 +594,14 @@ bool TransportSystem::initialize(const std::string& db_path) {
     return pimpl->initialize(db_path);
 }
 
+bool TransportSystem::initialize(const std::string& db_path, const std::string& snapshot_path) {
+    return pimpl->initialize(db_path, snapshot_path);
+}
+
+bool TransportSystem::save_snapshot(const std::string& path) const {
+    return pimpl->save_snapshot(path);
+}
+
 void TransportSystem::shutdown() {
     pimpl->shutdown();
 }
@@ -237,6 +630,14 @@ std::vector<Route> TransportSystem::get_all_routes() const {
     return pimpl->get_all_routes();
 }
 
+EntityCacheStats TransportSystem::entity_cache_stats() const {
+    return pimpl->entity_cache_stats();
+}
+
+void TransportSystem::invalidate_entity_cache() {
+    pimpl->invalidate_entity_cache();
+}
+
 bool TransportSystem::add_trip(const Trip& trip) {
     // Implementación básica - se puede expandir
     return true;
@@ -250,6 +651,57 @@ std::vector<int> TransportSystem::find_shortest_path(int start_stop, int end_sto
     return pimpl->find_shortest_path(start_stop, end_stop);
 }
 
+std::vector<std::vector<int>> TransportSystem::find_shortest_paths(
+    const std::vector<std::pair<int, int>>& queries) const {
+    return pimpl->find_shortest_paths(queries);
+}
+
+void TransportSystem::set_routing_algorithm(RoutingAlgorithm algorithm) {
+    pimpl->set_routing_algorithm(algorithm);
+}
+
+std::vector<std::pair<int, double>> TransportSystem::reachable_within(int stop_id,
+                                                                     double max_distance) const {
+    return pimpl->reachable_within(stop_id, max_distance);
+}
+
+Journey TransportSystem::earliest_arrival(int start_stop, int end_stop,
+                                          const std::string& departure_time,
+                                          int max_transfers) const {
+    return pimpl->earliest_arrival(start_stop, end_stop, departure_time, max_transfers);
+}
+
+std::vector<ProfileEntry> TransportSystem::departure_profile(int start_stop, int end_stop,
+                                                            const std::string& window_start,
+                                                            const std::string& window_end) const {
+    return pimpl->departure_profile(start_stop, end_stop, window_start, window_end);
+}
+
+RoutingAlgorithm TransportSystem::routing_algorithm() const {
+    return pimpl->routing_algorithm();
+}
+
+uint64_t TransportSystem::network_version() const {
+    return pimpl->network_version();
+}
+
+void TransportSystem::set_landmark_count(size_t count) {
+    pimpl->set_landmark_count(count);
+}
+
+bool TransportSystem::update_edge_weight(int from_stop, int to_stop, double weight) {
+    return pimpl->update_edge_weight(from_stop, to_stop, weight);
+}
+
+std::vector<double> TransportSystem::distance_matrix(const std::vector<int>& sources,
+                                                     const std::vector<int>& targets) const {
+    return pimpl->distance_matrix(sources, targets);
+}
+
 std::vector<Route> TransportSystem::find_routes_through_stop(int stop_id) const {
     return pimpl->find_routes_through_stop(stop_id);
+}
+
+std::vector<Route> TransportSystem::find_direct_routes(int from_stop, int to_stop) const {
+    return pimpl->find_direct_routes(from_stop, to_stop);
 }
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include "core/connection_table.h"
+#include <algorithm>
+
+using namespace urban_transport;
+
+ConnectionTable::ConnectionTable(const std::vector<ScheduledTrip>& trips) {
+    for (const auto& trip : trips) {
+        if (trip.stop_ids.size() != trip.times.size()) continue;
+        stop_ids_.insert(stop_ids_.end(), trip.stop_ids.begin(), trip.stop_ids.end());
+    }
+    std::sort(stop_ids_.begin(), stop_ids_.end());
+    stop_ids_.erase(std::unique(stop_ids_.begin(), stop_ids_.end()), stop_ids_.end());
+
+    for (const auto& trip : trips) {
+        if (trip.stop_ids.size() != trip.times.size()) continue;
+        int trip_index = static_cast<int>(trip_ids_.size());
+        bool added = false;
+        for (size_t i = 0; i + 1 < trip.stop_ids.size(); ++i) {
+            // Tramos sin hora o que retroceden en el tiempo no se pueden escanear
+            if (trip.times[i] == NO_SERVICE_TIME || trip.times[i + 1] == NO_SERVICE_TIME) continue;
+            if (trip.times[i + 1] < trip.times[i]) continue;
+            connections_.push_back({index_of(trip.stop_ids[i]), index_of(trip.stop_ids[i + 1]),
+                                    trip.times[i], trip.times[i + 1], trip_index});
+            added = true;
+        }
+        if (added) trip_ids_.push_back(trip.trip_id);
+    }
+
+    // A igual salida, primero las que llegan antes: una conexión de duración
+    // cero debe escanearse antes que la que sale de su parada de llegada
+    std::stable_sort(connections_.begin(), connections_.end(), [](const Connection& a, const Connection& b) {
+        return a.departure_time != b.departure_time ? a.departure_time < b.departure_time
+                                                    : a.arrival_time < b.arrival_time;
+    });
+}
+
+int ConnectionTable::index_of(int stop_id) const {
+    auto it = std::lower_bound(stop_ids_.begin(), stop_ids_.end(), stop_id);
+    if (it == stop_ids_.end() || *it != stop_id) return -1;
+    return static_cast<int>(it - stop_ids_.begin());
+}
+
+size_t ConnectionTable::first_departure(int time) const {
+    auto it = std::lower_bound(connections_.begin(), connections_.end(), time,
+                               [](const Connection& c, int t) { return c.departure_time < t; });
+    return static_cast<size_t>(it - connections_.begin());
+}
@@ -0,0 +1,438 @@
+#include "core/contraction_hierarchy.h"
+#include "core/thread_pool.h"
+#include <algorithm>
+#include <fstream>
+#include <limits>
+
+using namespace urban_transport;
+
+namespace {
+
+constexpr uint32_t CH_FILE_MAGIC = 0x48435455; // "UTCH"
+constexpr uint32_t CH_FILE_VERSION = 1;
+
+// Límite de nodos asentados por búsqueda de testigos. Si se alcanza se
+// añade el atajo: sobra algún arco, pero las distancias siguen siendo exactas.
+constexpr size_t WITNESS_SETTLE_LIMIT = 500;
+
+const double INF = std::numeric_limits<double>::infinity();
+
+struct DynamicArc {
+    int node;
+    double weight;
+    int middle;
+};
+
+struct Shortcut {
+    int from;
+    int to;
+    double weight;
+};
+
+// Grafo mutable usado solo durante el preprocesado
+class Contractor {
+public:
+    explicit Contractor(const CsrGraph& graph)
+        : out_(graph.node_count()), in_(graph.node_count()),
+          in_set_(graph.node_count(), 0), contracted_neighbors_(graph.node_count(), 0) {
+        for (size_t u = 0; u < graph.node_count(); ++u) {
+            int from = static_cast<int>(u);
+            for (uint32_t e = graph.edge_begin(from); e < graph.edge_end(from); ++e) {
+                int to = graph.edge_target(e);
+                if (to != from) add_arc(from, to, graph.edge_weight(e), -1);
+            }
+        }
+    }
+
+    size_t node_count() const { return out_.size(); }
+
+    // Devuelve true si el arco es nuevo o mejora el existente
+    bool add_arc(int from, int to, double weight, int middle) {
+        for (auto& arc : out_[from]) {
+            if (arc.node != to) continue;
+            if (weight >= arc.weight) return false;
+            arc.weight = weight;
+            arc.middle = middle;
+            for (auto& back : in_[to]) {
+                if (back.node == from) {
+                    back.weight = weight;
+                    back.middle = middle;
+                }
+            }
+            return true;
+        }
+        out_[from].push_back({to, weight, middle});
+        in_[to].push_back({from, weight, middle});
+        return true;
+    }
+
+    // Atajos necesarios al contraer v. Con exclude_set las búsquedas de
+    // testigos evitan también los nodos que se contraen en la misma ronda.
+    void find_shortcuts(int v, bool exclude_set, SearchWorkspace& workspace,
+                        std::vector<Shortcut>& result) const {
+        result.clear();
+        for (const auto& incoming : in_[v]) {
+            int u = incoming.node;
+            double max_via = -1.0;
+            for (const auto& outgoing : out_[v]) {
+                if (outgoing.node != u) max_via = std::max(max_via, incoming.weight + outgoing.weight);
+            }
+            if (max_via < 0.0) continue;
+
+            workspace.reset(node_count());
+            workspace.set_distance(u, 0.0, -1);
+            workspace.push(0.0, u);
+            size_t settled = 0;
+            while (!workspace.heap_empty()) {
+                auto [dist, x] = workspace.pop();
+                if (workspace.settled(x)) continue;
+                workspace.settle(x);
+                if (dist > max_via || ++settled > WITNESS_SETTLE_LIMIT) break;
+
+                for (const auto& arc : out_[x]) {
+                    if (arc.node == v || (exclude_set && in_set_[arc.node])) continue;
+                    double new_dist = dist + arc.weight;
+                    if (new_dist < workspace.distance(arc.node)) {
+                        workspace.set_distance(arc.node, new_dist, x);
+                        workspace.push(new_dist, arc.node);
+                    }
+                }
+            }
+
+            for (const auto& outgoing : out_[v]) {
+                if (outgoing.node == u) continue;
+                double via = incoming.weight + outgoing.weight;
+                if (workspace.distance(outgoing.node) > via) {
+                    result.push_back({u, outgoing.node, via});
+                }
+            }
+        }
+    }
+
+    // Diferencia de aristas más vecinos ya contraídos (reparte la contracción)
+    double priority(int v, SearchWorkspace& workspace, std::vector<Shortcut>& scratch) const {
+        find_shortcuts(v, false, workspace, scratch);
+        double degree = static_cast<double>(in_[v].size() + out_[v].size());
+        return static_cast<double>(scratch.size()) - degree + contracted_neighbors_[v];
+    }
+
+    // v se contrae en esta ronda si ningún vecino tiene menor prioridad
+    bool is_local_minimum(int v, const std::vector<double>& priorities) const {
+        auto precedes = [&](int w) {
+            return priorities[w] < priorities[v] || (priorities[w] == priorities[v] && w < v);
+        };
+        for (const auto& arc : out_[v]) if (precedes(arc.node)) return false;
+        for (const auto& arc : in_[v]) if (precedes(arc.node)) return false;
+        return true;
+    }
+
+    void mark_in_set(int v, bool value) { in_set_[v] = value ? 1 : 0; }
+
+    // Retira v del grafo restante; devuelve sus arcos hacia nodos de mayor rango
+    void contract(int v, const std::vector<Shortcut>& shortcuts, std::vector<char>& dirty,
+                  std::vector<DynamicArc>& up, std::vector<DynamicArc>& down) {
+        up = std::move(out_[v]);
+        down = std::move(in_[v]);
+        out_[v].clear();
+        in_[v].clear();
+
+        auto detach = [&](std::vector<DynamicArc>& arcs) {
+            arcs.erase(std::remove_if(arcs.begin(), arcs.end(),
+                                      [&](const DynamicArc& arc) { return arc.node == v; }),
+                       arcs.end());
+        };
+        for (const auto& arc : up) {
+            detach(in_[arc.node]);
+            dirty[arc.node] = 1;
+            ++contracted_neighbors_[arc.node];
+        }
+        for (const auto& arc : down) {
+            detach(out_[arc.node]);
+            dirty[arc.node] = 1;
+            ++contracted_neighbors_[arc.node];
+        }
+
+        for (const auto& shortcut : shortcuts) {
+            add_arc(shortcut.from, shortcut.to, shortcut.weight, v);
+        }
+        in_set_[v] = 0;
+    }
+
+private:
+    std::vector<std::vector<DynamicArc>> out_;
+    std::vector<std::vector<DynamicArc>> in_;
+    std::vector<char> in_set_;
+    std::vector<int> contracted_neighbors_;
+};
+
+void flatten(const std::vector<std::vector<DynamicArc>>& arcs, std::vector<uint32_t>& offsets,
+             std::vector<int>& targets, std::vector<double>& weights, std::vector<int>& middles) {
+    offsets.assign(1, 0);
+    for (const auto& list : arcs) {
+        for (const auto& arc : list) {
+            targets.push_back(arc.node);
+            weights.push_back(arc.weight);
+            middles.push_back(arc.middle);
+        }
+        offsets.push_back(static_cast<uint32_t>(targets.size()));
+    }
+}
+
+template <typename T>
+void write_vector(std::ofstream& out, const std::vector<T>& values) {
+    uint64_t size = values.size();
+    out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(size * sizeof(T)));
+}
+
+template <typename T>
+bool read_vector(std::ifstream& in, std::vector<T>& values) {
+    uint64_t size = 0;
+    if (!in.read(reinterpret_cast<char*>(&size), sizeof(size))) return false;
+    if (size > std::numeric_limits<uint32_t>::max()) return false;
+    values.resize(size);
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(values.data()),
+                                     static_cast<std::streamsize>(size * sizeof(T))));
+}
+
+bool valid_arcs(const std::vector<uint32_t>& offsets, const std::vector<int>& targets,
+                const std::vector<double>& weights, const std::vector<int>& middles, size_t n) {
+    if (offsets.size() != n + 1 || offsets.front() != 0 || offsets.back() != targets.size()) return false;
+    if (weights.size() != targets.size() || middles.size() != targets.size()) return false;
+    for (size_t i = 0; i < n; ++i) {
+        if (offsets[i] > offsets[i + 1]) return false;
+    }
+    for (size_t e = 0; e < targets.size(); ++e) {
+        if (targets[e] < 0 || static_cast<size_t>(targets[e]) >= n) return false;
+        if (middles[e] < -1 || middles[e] >= static_cast<int>(n)) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+ContractionHierarchy::ContractionHierarchy(const CsrGraph& graph, size_t thread_count) {
+    const size_t n = graph.node_count();
+    node_ids_.reserve(n);
+    for (size_t i = 0; i < n; ++i) node_ids_.push_back(graph.node_id(static_cast<int>(i)));
+    rank_.assign(n, 0);
+
+    Contractor contractor(graph);
+    ThreadPool pool(thread_count);
+    std::vector<SearchWorkspace> workspaces(pool.size());
+    std::vector<std::vector<Shortcut>> scratch(pool.size());
+
+    std::vector<int> remaining(n);
+    for (size_t i = 0; i < n; ++i) remaining[i] = static_cast<int>(i);
+    std::vector<double> priorities(n, 0.0);
+    std::vector<char> dirty(n, 1);
+    std::vector<char> contracted(n, 0);
+    std::vector<std::vector<DynamicArc>> up(n);
+    std::vector<std::vector<DynamicArc>> down(n);
+    int next_rank = 0;
+
+    while (!remaining.empty()) {
+        // Solo se recalculan los nodos cuyos vecinos cambiaron
+        pool.parallel_for(remaining.size(), [&](size_t i, size_t worker) {
+            int v = remaining[i];
+            if (dirty[v]) priorities[v] = contractor.priority(v, workspaces[worker], scratch[worker]);
+        });
+        for (int v : remaining) dirty[v] = 0;
+
+        std::vector<int> selected;
+        for (int v : remaining) {
+            if (contractor.is_local_minimum(v, priorities)) selected.push_back(v);
+        }
+        for (int v : selected) contractor.mark_in_set(v, true);
+
+        // Los nodos seleccionados no son adyacentes: sus atajos se calculan a la
+        // vez sobre el grafo actual y se aplican después en serie
+        std::vector<std::vector<Shortcut>> shortcuts(selected.size());
+        pool.parallel_for(selected.size(), [&](size_t i, size_t worker) {
+            contractor.find_shortcuts(selected[i], true, workspaces[worker], shortcuts[i]);
+        });
+
+        for (size_t i = 0; i < selected.size(); ++i) {
+            int v = selected[i];
+            rank_[v] = next_rank++;
+            contracted[v] = 1;
+            contractor.contract(v, shortcuts[i], dirty, up[v], down[v]);
+        }
+
+        remaining.erase(std::remove_if(remaining.begin(), remaining.end(),
+                                       [&](int v) { return contracted[v] != 0; }),
+                        remaining.end());
+    }
+
+    flatten(up, up_offsets_, up_targets_, up_weights_, up_middles_);
+    flatten(down, down_offsets_, down_targets_, down_weights_, down_middles_);
+    shortcut_count_ = std::count_if(up_middles_.begin(), up_middles_.end(), [](int m) { return m >= 0; }) +
+                      std::count_if(down_middles_.begin(), down_middles_.end(), [](int m) { return m >= 0; });
+}
+
+int ContractionHierarchy::index_of(int node_id) const {
+    auto it = std::lower_bound(node_ids_.begin(), node_ids_.end(), node_id);
+    if (it == node_ids_.end() || *it != node_id) return -1;
+    return static_cast<int>(it - node_ids_.begin());
+}
+
+std::vector<int> ContractionHierarchy::shortest_path(int start_node, int end_node) const {
+    return shortest_path(start_node, end_node, BidirectionalWorkspace::for_current_thread());
+}
+
+std::vector<int> ContractionHierarchy::shortest_path(int start_node, int end_node,
+                                                     BidirectionalWorkspace& workspace) const {
+    int source = index_of(start_node);
+    int target = index_of(end_node);
+    if (source < 0 || target < 0) return {};
+    if (source == target) return {start_node};
+
+    SearchWorkspace& forward = workspace.forward;
+    SearchWorkspace& backward = workspace.backward;
+    forward.reset(node_count());
+    backward.reset(node_count());
+    forward.set_distance(source, 0.0, -1);
+    forward.push(0.0, source);
+    backward.set_distance(target, 0.0, -1);
+    backward.push(0.0, target);
+
+    double best = INF;
+    int meeting = -1;
+
+    // Ambas búsquedas solo suben de rango; cada una se detiene cuando su
+    // mínimo ya no puede mejorar el mejor camino encontrado
+    while (true) {
+        bool forward_active = !forward.heap_empty() && forward.top().key < best;
+        bool backward_active = !backward.heap_empty() && backward.top().key < best;
+        if (!forward_active && !backward_active) break;
+
+        bool expand_forward = forward_active &&
+                              (!backward_active || forward.top().key <= backward.top().key);
+        SearchWorkspace& self = expand_forward ? forward : backward;
+        SearchWorkspace& other = expand_forward ? backward : forward;
+
+        int current = self.pop().node;
+        if (self.settled(current)) continue;
+        self.settle(current);
+
+        double current_dist = self.distance(current);
+        if (other.reached(current) && current_dist + other.distance(current) < best) {
+            best = current_dist + other.distance(current);
+            meeting = current;
+        }
+
+        const auto& offsets = expand_forward ? up_offsets_ : down_offsets_;
+        const auto& targets = expand_forward ? up_targets_ : down_targets_;
+        const auto& weights = expand_forward ? up_weights_ : down_weights_;
+        for (uint32_t e = offsets[current]; e < offsets[current + 1]; ++e) {
+            int next = targets[e];
+            double new_dist = current_dist + weights[e];
+            if (new_dist < self.distance(next)) {
+                self.set_distance(next, new_dist, current);
+                self.push(new_dist, next);
+            }
+        }
+    }
+
+    if (meeting < 0) return {};
+
+    std::vector<int> chain;
+    for (int node = meeting; node != -1; node = forward.parent(node)) chain.push_back(node);
+    std::reverse(chain.begin(), chain.end());
+
+    std::vector<int> path = {start_node};
+    for (size_t i = 0; i + 1 < chain.size(); ++i) {
+        unpack(chain[i], chain[i + 1], up_middle(chain[i], chain[i + 1]), path);
+    }
+    for (int node = meeting, next = backward.parent(meeting); next != -1;
+         node = next, next = backward.parent(next)) {
+        unpack(node, next, down_middle(node, next), path);
+    }
+    return path;
+}
+
+int ContractionHierarchy::up_middle(int from, int to) const {
+    for (uint32_t e = up_offsets_[from]; e < up_offsets_[from + 1]; ++e) {
+        if (up_targets_[e] == to) return up_middles_[e];
+    }
+    return -1;
+}
+
+int ContractionHierarchy::down_middle(int from, int to) const {
+    for (uint32_t e = down_offsets_[to]; e < down_offsets_[to + 1]; ++e) {
+        if (down_targets_[e] == from) return down_middles_[e];
+    }
+    return -1;
+}
+
+void ContractionHierarchy::unpack(int from, int to, int middle, std::vector<int>& path) const {
+    struct Segment {
+        int from;
+        int to;
+        int middle;
+    };
+    std::vector<Segment> pending = {{from, to, middle}};
+    while (!pending.empty()) {
+        Segment segment = pending.back();
+        pending.pop_back();
+        if (segment.middle < 0) {
+            path.push_back(node_ids_[segment.to]);
+            continue;
+        }
+        // El intermedio tiene menor rango que ambos extremos
+        int m = segment.middle;
+        pending.push_back({m, segment.to, up_middle(m, segment.to)});
+        pending.push_back({segment.from, m, down_middle(segment.from, m)});
+    }
+}
+
+bool ContractionHierarchy::save(const std::string& filename) const {
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    out.write(reinterpret_cast<const char*>(&CH_FILE_MAGIC), sizeof(CH_FILE_MAGIC));
+    out.write(reinterpret_cast<const char*>(&CH_FILE_VERSION), sizeof(CH_FILE_VERSION));
+    write_vector(out, node_ids_);
+    write_vector(out, rank_);
+    write_vector(out, up_offsets_);
+    write_vector(out, up_targets_);
+    write_vector(out, up_weights_);
+    write_vector(out, up_middles_);
+    write_vector(out, down_offsets_);
+    write_vector(out, down_targets_);
+    write_vector(out, down_weights_);
+    write_vector(out, down_middles_);
+    return static_cast<bool>(out);
+}
+
+bool ContractionHierarchy::load(const std::string& filename) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in) return false;
+
+    uint32_t magic = 0, version = 0;
+    in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    in.read(reinterpret_cast<char*>(&version), sizeof(version));
+    if (!in || magic != CH_FILE_MAGIC || version != CH_FILE_VERSION) return false;
+
+    ContractionHierarchy loaded;
+    bool ok = read_vector(in, loaded.node_ids_) && read_vector(in, loaded.rank_) &&
+              read_vector(in, loaded.up_offsets_) && read_vector(in, loaded.up_targets_) &&
+              read_vector(in, loaded.up_weights_) && read_vector(in, loaded.up_middles_) &&
+              read_vector(in, loaded.down_offsets_) && read_vector(in, loaded.down_targets_) &&
+              read_vector(in, loaded.down_weights_) && read_vector(in, loaded.down_middles_);
+    if (!ok) return false;
+
+    size_t n = loaded.node_ids_.size();
+    if (loaded.rank_.size() != n ||
+        !std::is_sorted(loaded.node_ids_.begin(), loaded.node_ids_.end()) ||
+        !valid_arcs(loaded.up_offsets_, loaded.up_targets_, loaded.up_weights_, loaded.up_middles_, n) ||
+        !valid_arcs(loaded.down_offsets_, loaded.down_targets_, loaded.down_weights_, loaded.down_middles_, n)) {
+        return false;
+    }
+
+    loaded.shortcut_count_ =
+        std::count_if(loaded.up_middles_.begin(), loaded.up_middles_.end(), [](int m) { return m >= 0; }) +
+        std::count_if(loaded.down_middles_.begin(), loaded.down_middles_.end(), [](int m) { return m >= 0; });
+    *this = std::move(loaded);
+    return true;
+}
@@ -0,0 +1,103 @@
+#include "core/csr_graph.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace urban_transport;
+
+namespace {
+
+// Arrays propios de un CsrGraph construido en memoria
+struct CsrStorage {
+    std::vector<int> node_ids;
+    std::vector<uint32_t> offsets;
+    std::vector<int> targets;
+    std::vector<double> weights;
+    std::vector<uint32_t> in_offsets;
+    std::vector<int> in_sources;
+    std::vector<double> in_weights;
+    std::vector<double> latitudes;
+    std::vector<double> longitudes;
+};
+
+} // namespace
+
+CsrGraph::CsrGraph(const Graph& graph) {
+    auto storage = std::make_shared<CsrStorage>();
+    auto& node_ids = storage->node_ids;
+    node_ids = graph.get_all_nodes();
+    std::sort(node_ids.begin(), node_ids.end());
+    const size_t n = node_ids.size();
+
+    auto dense_index = [&](int id) {
+        return static_cast<int>(std::lower_bound(node_ids.begin(), node_ids.end(), id) - node_ids.begin());
+    };
+
+    const double NO_COORDINATE = std::numeric_limits<double>::quiet_NaN();
+    storage->latitudes.assign(n, NO_COORDINATE);
+    storage->longitudes.assign(n, NO_COORDINATE);
+    for (size_t i = 0; i < n; ++i) {
+        graph.get_coordinates(node_ids[i], storage->latitudes[i], storage->longitudes[i]);
+    }
+
+    auto& offsets = storage->offsets;
+    offsets.reserve(n + 1);
+    offsets.push_back(0);
+    size_t total_edges = 0;
+    for (int node : node_ids) {
+        total_edges += graph.get_edges(node).size();
+        offsets.push_back(static_cast<uint32_t>(total_edges));
+    }
+
+    auto& targets = storage->targets;
+    auto& weights = storage->weights;
+    targets.reserve(total_edges);
+    weights.reserve(total_edges);
+    for (int node : node_ids) {
+        for (const auto& edge : graph.get_edges(node)) {
+            targets.push_back(dense_index(edge.target));
+            weights.push_back(edge.weight);
+        }
+    }
+
+    // CSR inverso: transpuesta de las aristas salientes
+    auto& in_offsets = storage->in_offsets;
+    in_offsets.assign(n + 1, 0);
+    for (int target : targets) ++in_offsets[target + 1];
+    for (size_t i = 0; i < n; ++i) in_offsets[i + 1] += in_offsets[i];
+
+    storage->in_sources.resize(total_edges);
+    storage->in_weights.resize(total_edges);
+    std::vector<uint32_t> cursor(in_offsets.begin(), in_offsets.end() - 1);
+    for (size_t from = 0; from < n; ++from) {
+        for (uint32_t e = offsets[from]; e < offsets[from + 1]; ++e) {
+            uint32_t slot = cursor[targets[e]]++;
+            storage->in_sources[slot] = static_cast<int>(from);
+            storage->in_weights[slot] = weights[e];
+        }
+    }
+
+    node_count_ = n;
+    edge_count_ = total_edges;
+    node_ids_ = storage->node_ids.data();
+    offsets_ = storage->offsets.data();
+    targets_ = storage->targets.data();
+    weights_ = storage->weights.data();
+    in_offsets_ = storage->in_offsets.data();
+    in_sources_ = storage->in_sources.data();
+    in_weights_ = storage->in_weights.data();
+    latitudes_ = storage->latitudes.data();
+    longitudes_ = storage->longitudes.data();
+    owner_ = std::move(storage);
+}
+
+int CsrGraph::index_of(int node_id) const {
+    const int* end = node_ids_ + node_count_;
+    const int* it = std::lower_bound(node_ids_, end, node_id);
+    if (it == end || *it != node_id) return -1;
+    return static_cast<int>(it - node_ids_);
+}
+
+bool CsrGraph::has_coordinates(int index) const {
+    return !std::isnan(latitudes_[index]) && !std::isnan(longitudes_[index]);
+}
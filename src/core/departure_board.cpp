@@ -0,0 +1,117 @@
+#include "core/departure_board.h"
+#include <algorithm>
+#include <limits>
+
+using namespace urban_transport;
+
+namespace {
+
+constexpr int SECONDS_PER_DAY = 24 * 3600;
+
+} // namespace
+
+void DepartureBoard::add(int stop_id, int time, int trip_id, int route_id) {
+    StopDepartures& stop = stops_[stop_id];
+    // Las paradas del viaje son pocas: se mira ahí antes que en el array
+    auto& trip_stops = trip_stops_[trip_id];
+    if (std::find(trip_stops.begin(), trip_stops.end(), stop_id) != trip_stops.end()) {
+        if (erase(stop, trip_id)) --departure_count_;
+    } else {
+        trip_stops.push_back(stop_id);
+    }
+
+    // Tras las salidas a la misma hora: conserva el orden de llegada
+    size_t position = std::upper_bound(stop.times.begin(), stop.times.end(), time) - stop.times.begin();
+    stop.times.insert(stop.times.begin() + position, time);
+    stop.trip_ids.insert(stop.trip_ids.begin() + position, trip_id);
+    stop.route_ids.insert(stop.route_ids.begin() + position, route_id);
+    ++departure_count_;
+}
+
+void DepartureBoard::remove_trip(int trip_id) {
+    auto trip = trip_stops_.find(trip_id);
+    if (trip == trip_stops_.end()) return;
+    for (int stop_id : trip->second) {
+        auto stop = stops_.find(stop_id);
+        if (stop == stops_.end() || !erase(stop->second, trip_id)) continue;
+        --departure_count_;
+        if (stop->second.times.empty()) stops_.erase(stop);
+    }
+    trip_stops_.erase(trip);
+}
+
+void DepartureBoard::set_trip_route(int trip_id, int route_id) {
+    auto trip = trip_stops_.find(trip_id);
+    if (trip == trip_stops_.end()) return;
+    for (int stop_id : trip->second) {
+        StopDepartures& stop = stops_.at(stop_id);
+        for (size_t i = 0; i < stop.trip_ids.size(); ++i) {
+            if (stop.trip_ids[i] == trip_id) stop.route_ids[i] = route_id;
+        }
+    }
+}
+
+std::vector<Departure> DepartureBoard::next_departures(int stop_id, int time, size_t count) const {
+    std::vector<Departure> result;
+    if (count == 0) return result;
+    scan(stop_id, time, std::numeric_limits<int>::max() - SECONDS_PER_DAY, [&](const Departure& departure) {
+        result.push_back(departure);
+        return result.size() < count;
+    });
+    return result;
+}
+
+std::vector<RouteDepartures> DepartureBoard::next_departures_by_route(int stop_id, int time, int window,
+                                                                      size_t per_route) const {
+    std::vector<RouteDepartures> groups;
+    if (per_route == 0 || window < 0) return groups;
+    std::unordered_map<int, size_t> group_of;
+    scan(stop_id, time, time + window, [&](const Departure& departure) {
+        auto [it, inserted] = group_of.emplace(departure.route_id, groups.size());
+        if (inserted) groups.push_back({departure.route_id, {}});
+        auto& departures = groups[it->second].departures;
+        if (departures.size() < per_route) departures.push_back(departure);
+        return true;
+    });
+    return groups;
+}
+
+bool DepartureBoard::erase(StopDepartures& stop, int trip_id) {
+    for (size_t i = 0; i < stop.trip_ids.size(); ++i) {
+        if (stop.trip_ids[i] != trip_id) continue;
+        stop.times.erase(stop.times.begin() + i);
+        stop.trip_ids.erase(stop.trip_ids.begin() + i);
+        stop.route_ids.erase(stop.route_ids.begin() + i);
+        return true;
+    }
+    return false;
+}
+
+template <typename Visit>
+void DepartureBoard::scan(int stop_id, int from, int until, Visit visit) const {
+    auto it = stops_.find(stop_id);
+    if (it == stops_.end() || from > until) return;
+    const StopDepartures& stop = it->second;
+    const auto& times = stop.times;
+    auto departure_at = [&](size_t i) { return Departure{times[i], stop.trip_ids[i], stop.route_ids[i]}; };
+
+    // Dos tramos ordenados del mismo array: las salidas del día y, antes de
+    // las 24:00, las 24:xx del día anterior, que se mezclan por hora real
+    size_t today = std::lower_bound(times.begin(), times.end(), from) - times.begin();
+    size_t today_end = std::upper_bound(times.begin(), times.end(), until) - times.begin();
+    size_t previous = times.size();
+    size_t previous_end = times.size();
+    if (from < SECONDS_PER_DAY) {
+        previous = std::lower_bound(times.begin(), times.end(), from + SECONDS_PER_DAY) - times.begin();
+        previous_end = std::upper_bound(times.begin(), times.end(), until + SECONDS_PER_DAY) - times.begin();
+        // Los tramos no se solapan: el del día acaba donde empieza el otro
+        today_end = std::min(today_end, previous);
+    }
+
+    while (today < today_end || previous < previous_end) {
+        bool take_previous = previous < previous_end &&
+                             (today == today_end || times[previous] - SECONDS_PER_DAY <= times[today]);
+        size_t i = take_previous ? previous++ : today++;
+        if (!visit(departure_at(i))) return;
+    }
+}
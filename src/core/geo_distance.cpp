@@ -0,0 +1,239 @@
+#include "core/geo_distance.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define URBAN_TRANSPORT_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+using namespace urban_transport;
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+constexpr double DEG_TO_RAD = PI / 180.0;
+constexpr double EARTH_RADIUS_KM = 6371.0;
+
+// Por debajo de este sin(c/2) (unos 1270 km) la serie de asin hasta x^15
+// tiene un error relativo menor que 1e-17
+constexpr double SERIES_LIMIT = 0.1;
+
+// Coeficientes de asin(x) = x * sum(c_n * x^2n), n = 0..7
+constexpr double ASIN_C1 = 1.0 / 6.0;
+constexpr double ASIN_C2 = 3.0 / 40.0;
+constexpr double ASIN_C3 = 5.0 / 112.0;
+constexpr double ASIN_C4 = 35.0 / 1152.0;
+constexpr double ASIN_C5 = 63.0 / 2816.0;
+constexpr double ASIN_C6 = 231.0 / 13312.0;
+constexpr double ASIN_C7 = 143.0 / 10240.0;
+
+// Datos del origen que comparten todos los núcleos
+struct Origin {
+    double cos_latitude;
+    double sin_half_latitude;
+    double cos_half_latitude;
+    double sin_half_longitude;
+    double cos_half_longitude;
+
+    Origin(double latitude, double longitude) {
+        double phi = latitude * DEG_TO_RAD;
+        double lambda = longitude * DEG_TO_RAD;
+        cos_latitude = std::cos(phi);
+        sin_half_latitude = std::sin(phi / 2);
+        cos_half_latitude = std::cos(phi / 2);
+        sin_half_longitude = std::sin(lambda / 2);
+        cos_half_longitude = std::cos(lambda / 2);
+    }
+};
+
+// a = sin²(Δφ/2) + cos φ0 cos φ sin²(Δλ/2) para el punto i; sin(Δ/2) sale
+// de la fórmula de la resta con semiángulos, sin cancelación catastrófica
+inline double haversine_term(const Origin& o, const CoordinateBlock& block, size_t i) {
+    double sin_dphi = block.sin_half_latitudes()[i] * o.cos_half_latitude -
+                      block.cos_half_latitudes()[i] * o.sin_half_latitude;
+    double sin_dlambda = block.sin_half_longitudes()[i] * o.cos_half_longitude -
+                         block.cos_half_longitudes()[i] * o.sin_half_longitude;
+    return sin_dphi * sin_dphi + o.cos_latitude * block.cos_latitudes()[i] * sin_dlambda * sin_dlambda;
+}
+
+inline double distance_from_term(double a) {
+    return 2.0 * EARTH_RADIUS_KM * std::asin(std::sqrt(std::min(a, 1.0)));
+}
+
+void haversine_scalar(const Origin& o, const CoordinateBlock& block, size_t begin, double* out) {
+    for (size_t i = begin; i < block.size(); ++i) out[i] = distance_from_term(haversine_term(o, block, i));
+}
+
+#ifdef URBAN_TRANSPORT_X86_KERNELS
+
+void haversine_sse2(const Origin& o, const CoordinateBlock& block, double* out) {
+    const size_t n = block.size();
+    const __m128d cos_lat0 = _mm_set1_pd(o.cos_latitude);
+    const __m128d sin_hlat0 = _mm_set1_pd(o.sin_half_latitude);
+    const __m128d cos_hlat0 = _mm_set1_pd(o.cos_half_latitude);
+    const __m128d sin_hlon0 = _mm_set1_pd(o.sin_half_longitude);
+    const __m128d cos_hlon0 = _mm_set1_pd(o.cos_half_longitude);
+    const __m128d one = _mm_set1_pd(1.0);
+    const __m128d limit = _mm_set1_pd(SERIES_LIMIT);
+    const __m128d scale = _mm_set1_pd(2.0 * EARTH_RADIUS_KM);
+
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d sin_dphi = _mm_sub_pd(_mm_mul_pd(_mm_loadu_pd(block.sin_half_latitudes() + i), cos_hlat0),
+                                      _mm_mul_pd(_mm_loadu_pd(block.cos_half_latitudes() + i), sin_hlat0));
+        __m128d sin_dlambda = _mm_sub_pd(_mm_mul_pd(_mm_loadu_pd(block.sin_half_longitudes() + i), cos_hlon0),
+                                         _mm_mul_pd(_mm_loadu_pd(block.cos_half_longitudes() + i), sin_hlon0));
+        __m128d weight = _mm_mul_pd(cos_lat0, _mm_loadu_pd(block.cos_latitudes() + i));
+        __m128d a = _mm_add_pd(_mm_mul_pd(sin_dphi, sin_dphi),
+                               _mm_mul_pd(weight, _mm_mul_pd(sin_dlambda, sin_dlambda)));
+        __m128d s = _mm_sqrt_pd(_mm_min_pd(a, one));
+
+        __m128d s2 = _mm_mul_pd(s, s);
+        __m128d p = _mm_set1_pd(ASIN_C7);
+        p = _mm_add_pd(_mm_mul_pd(p, s2), _mm_set1_pd(ASIN_C6));
+        p = _mm_add_pd(_mm_mul_pd(p, s2), _mm_set1_pd(ASIN_C5));
+        p = _mm_add_pd(_mm_mul_pd(p, s2), _mm_set1_pd(ASIN_C4));
+        p = _mm_add_pd(_mm_mul_pd(p, s2), _mm_set1_pd(ASIN_C3));
+        p = _mm_add_pd(_mm_mul_pd(p, s2), _mm_set1_pd(ASIN_C2));
+        p = _mm_add_pd(_mm_mul_pd(p, s2), _mm_set1_pd(ASIN_C1));
+        p = _mm_add_pd(_mm_mul_pd(p, s2), one);
+        _mm_storeu_pd(out + i, _mm_mul_pd(scale, _mm_mul_pd(s, p)));
+
+        // Carriles fuera del rango de la serie: asin exacto
+        if (_mm_movemask_pd(_mm_cmpgt_pd(s, limit))) {
+            for (size_t j = i; j < i + 2; ++j) out[j] = distance_from_term(haversine_term(o, block, j));
+        }
+    }
+    haversine_scalar(o, block, i, out);
+}
+
+__attribute__((target("avx2,fma")))
+void haversine_avx2(const Origin& o, const CoordinateBlock& block, double* out) {
+    const size_t n = block.size();
+    const __m256d cos_lat0 = _mm256_set1_pd(o.cos_latitude);
+    const __m256d sin_hlat0 = _mm256_set1_pd(o.sin_half_latitude);
+    const __m256d cos_hlat0 = _mm256_set1_pd(o.cos_half_latitude);
+    const __m256d sin_hlon0 = _mm256_set1_pd(o.sin_half_longitude);
+    const __m256d cos_hlon0 = _mm256_set1_pd(o.cos_half_longitude);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d limit = _mm256_set1_pd(SERIES_LIMIT);
+    const __m256d scale = _mm256_set1_pd(2.0 * EARTH_RADIUS_KM);
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d sin_dphi = _mm256_fmsub_pd(_mm256_loadu_pd(block.sin_half_latitudes() + i), cos_hlat0,
+                                           _mm256_mul_pd(_mm256_loadu_pd(block.cos_half_latitudes() + i), sin_hlat0));
+        __m256d sin_dlambda = _mm256_fmsub_pd(_mm256_loadu_pd(block.sin_half_longitudes() + i), cos_hlon0,
+                                              _mm256_mul_pd(_mm256_loadu_pd(block.cos_half_longitudes() + i), sin_hlon0));
+        __m256d weight = _mm256_mul_pd(cos_lat0, _mm256_loadu_pd(block.cos_latitudes() + i));
+        __m256d a = _mm256_fmadd_pd(sin_dphi, sin_dphi,
+                                    _mm256_mul_pd(weight, _mm256_mul_pd(sin_dlambda, sin_dlambda)));
+        __m256d s = _mm256_sqrt_pd(_mm256_min_pd(a, one));
+
+        __m256d s2 = _mm256_mul_pd(s, s);
+        __m256d p = _mm256_set1_pd(ASIN_C7);
+        p = _mm256_fmadd_pd(p, s2, _mm256_set1_pd(ASIN_C6));
+        p = _mm256_fmadd_pd(p, s2, _mm256_set1_pd(ASIN_C5));
+        p = _mm256_fmadd_pd(p, s2, _mm256_set1_pd(ASIN_C4));
+        p = _mm256_fmadd_pd(p, s2, _mm256_set1_pd(ASIN_C3));
+        p = _mm256_fmadd_pd(p, s2, _mm256_set1_pd(ASIN_C2));
+        p = _mm256_fmadd_pd(p, s2, _mm256_set1_pd(ASIN_C1));
+        p = _mm256_fmadd_pd(p, s2, one);
+        _mm256_storeu_pd(out + i, _mm256_mul_pd(scale, _mm256_mul_pd(s, p)));
+
+        if (_mm256_movemask_pd(_mm256_cmp_pd(s, limit, _CMP_GT_OQ))) {
+            for (size_t j = i; j < i + 4; ++j) out[j] = distance_from_term(haversine_term(o, block, j));
+        }
+    }
+    haversine_scalar(o, block, i, out);
+}
+
+#endif // URBAN_TRANSPORT_X86_KERNELS
+
+} // namespace
+
+void CoordinateBlock::reserve(size_t count) {
+    for (auto* column : {&latitudes_, &longitudes_, &cos_latitudes_, &sin_half_latitudes_,
+                         &cos_half_latitudes_, &sin_half_longitudes_, &cos_half_longitudes_}) {
+        column->reserve(count);
+    }
+}
+
+void CoordinateBlock::clear() {
+    for (auto* column : {&latitudes_, &longitudes_, &cos_latitudes_, &sin_half_latitudes_,
+                         &cos_half_latitudes_, &sin_half_longitudes_, &cos_half_longitudes_}) {
+        column->clear();
+    }
+}
+
+void CoordinateBlock::push_back(double latitude, double longitude) {
+    double phi = latitude * DEG_TO_RAD;
+    double lambda = longitude * DEG_TO_RAD;
+    latitudes_.push_back(phi);
+    longitudes_.push_back(lambda);
+    cos_latitudes_.push_back(std::cos(phi));
+    sin_half_latitudes_.push_back(std::sin(phi / 2));
+    cos_half_latitudes_.push_back(std::cos(phi / 2));
+    sin_half_longitudes_.push_back(std::sin(lambda / 2));
+    cos_half_longitudes_.push_back(std::cos(lambda / 2));
+}
+
+void CoordinateBlock::swap_remove(size_t index) {
+    for (auto* column : {&latitudes_, &longitudes_, &cos_latitudes_, &sin_half_latitudes_,
+                         &cos_half_latitudes_, &sin_half_longitudes_, &cos_half_longitudes_}) {
+        (*column)[index] = column->back();
+        column->pop_back();
+    }
+}
+
+DistanceKernel urban_transport::best_distance_kernel() {
+#ifdef URBAN_TRANSPORT_X86_KERNELS
+    static const DistanceKernel best = (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+                                           ? DistanceKernel::AVX2
+                                           : DistanceKernel::SSE2;
+    return best;
+#else
+    return DistanceKernel::SCALAR;
+#endif
+}
+
+void urban_transport::haversine_batch(double latitude, double longitude, const CoordinateBlock& block,
+                                      double* out, DistanceKernel kernel) {
+    const Origin origin(latitude, longitude);
+    DistanceKernel best = best_distance_kernel();
+    if (kernel == DistanceKernel::AUTO || kernel > best) kernel = best;
+
+    switch (kernel) {
+#ifdef URBAN_TRANSPORT_X86_KERNELS
+    case DistanceKernel::AVX2:
+        haversine_avx2(origin, block, out);
+        break;
+    case DistanceKernel::SSE2:
+        haversine_sse2(origin, block, out);
+        break;
+#endif
+    default:
+        haversine_scalar(origin, block, 0, out);
+        break;
+    }
+}
+
+void urban_transport::equirectangular_batch(double latitude, double longitude, const CoordinateBlock& block,
+                                            double* out) {
+    const Origin o(latitude, longitude);
+    const size_t n = block.size();
+    const double* sin_hlat = block.sin_half_latitudes();
+    const double* cos_hlat = block.cos_half_latitudes();
+    const double* sin_hlon = block.sin_half_longitudes();
+    const double* cos_hlon = block.cos_half_longitudes();
+
+    // x = Δλ cos φm, y = Δφ, con Δ ≈ 2 sin(Δ/2) y cos φm por suma de semiángulos
+    for (size_t i = 0; i < n; ++i) {
+        double dphi = 2.0 * (sin_hlat[i] * o.cos_half_latitude - cos_hlat[i] * o.sin_half_latitude);
+        double dlambda = 2.0 * (sin_hlon[i] * o.cos_half_longitude - cos_hlon[i] * o.sin_half_longitude);
+        double cos_mean = cos_hlat[i] * o.cos_half_latitude - sin_hlat[i] * o.sin_half_latitude;
+        double x = dlambda * cos_mean;
+        out[i] = EARTH_RADIUS_KM * std::sqrt(x * x + dphi * dphi);
+    }
+}
@@ -6,6 +6,7 @@ using namespace urban_transport;
 void Graph::add_node(int node_id) {
     if (adjacency_list.find(node_id) == adjacency_list.end()) {
         adjacency_list.emplace(node_id, std::vector<Edge>());
+        reverse_adjacency_list.emplace(node_id, std::vector<Edge>());
     }
 }
 
@@ -13,6 +14,7 @@ void Graph::add_edge(int from, int to, double weight) {
     add_node(from);
     add_node(to);
     adjacency_list[from].push_back(Edge(to, weight));
+    reverse_adjacency_list[to].push_back(Edge(from, weight));
 }
 
 void Graph::remove_edge(int from, int to) {
@@ -20,6 +22,43 @@ void Graph::remove_edge(int from, int to) {
     if (it == adjacency_list.end()) return;
     auto &edges = it->second;
     edges.erase(std::remove_if(edges.begin(), edges.end(), [&](const Edge &e) { return e.target == to; }), edges.end());
+
+    auto rit = reverse_adjacency_list.find(to);
+    if (rit == reverse_adjacency_list.end()) return;
+    auto &incoming = rit->second;
+    incoming.erase(std::remove_if(incoming.begin(), incoming.end(), [&](const Edge &e) { return e.target == from; }), incoming.end());
+}
+
+bool Graph::set_edge_weight(int from, int to, double weight) {
+    auto it = adjacency_list.find(from);
+    if (it == adjacency_list.end()) return false;
+
+    bool found = false;
+    for (auto &edge : it->second) {
+        if (edge.target == to) {
+            edge.weight = weight;
+            found = true;
+        }
+    }
+    if (!found) return false;
+
+    for (auto &edge : reverse_adjacency_list[to]) {
+        if (edge.target == from) edge.weight = weight;
+    }
+    return true;
+}
+
+void Graph::set_coordinates(int node_id, double latitude, double longitude) {
+    add_node(node_id);
+    coordinates[node_id] = {latitude, longitude};
+}
+
+bool Graph::get_coordinates(int node_id, double& latitude, double& longitude) const {
+    auto it = coordinates.find(node_id);
+    if (it == coordinates.end()) return false;
+    latitude = it->second.first;
+    longitude = it->second.second;
+    return true;
 }
 
 const std::vector<Edge>& Graph::get_edges(int node_id) const {
@@ -29,6 +68,13 @@ const std::vector<Edge>& Graph::get_edges(int node_id) const {
     return it->second;
 }
 
+const std::vector<Edge>& Graph::get_incoming_edges(int node_id) const {
+    static const std::vector<Edge> empty;
+    auto it = reverse_adjacency_list.find(node_id);
+    if (it == reverse_adjacency_list.end()) return empty;
+    return it->second;
+}
+
 bool Graph::has_node(int node_id) const {
     return adjacency_list.find(node_id) != adjacency_list.end();
 }
@@ -0,0 +1,193 @@
+#include "core/landmarks.h"
+#include "core/search_workspace.h"
+#include "core/thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+using namespace urban_transport;
+
+namespace {
+
+// Dijkstra completo desde varios orígenes; reverse recorre el CSR inverso.
+// Deja en order los nodos en orden de asentamiento.
+void full_search(const CsrGraph& graph, const std::vector<int>& sources, bool reverse,
+                 SearchWorkspace& workspace, std::vector<int>* order = nullptr) {
+    workspace.reset(graph.node_count());
+    for (int source : sources) {
+        workspace.set_distance(source, 0.0, -1);
+        workspace.push(0.0, source);
+    }
+    if (order) order->clear();
+
+    while (!workspace.heap_empty()) {
+        auto [dist, current] = workspace.pop();
+        if (workspace.settled(current)) continue;
+        workspace.settle(current);
+        if (order) order->push_back(current);
+
+        uint32_t begin = reverse ? graph.in_edge_begin(current) : graph.edge_begin(current);
+        uint32_t end = reverse ? graph.in_edge_end(current) : graph.edge_end(current);
+        for (uint32_t e = begin; e < end; ++e) {
+            int next = reverse ? graph.in_edge_source(e) : graph.edge_target(e);
+            double weight = reverse ? graph.in_edge_weight(e) : graph.edge_weight(e);
+            if (dist + weight < workspace.distance(next)) {
+                workspace.set_distance(next, dist + weight, current);
+                workspace.push(dist + weight, next);
+            }
+        }
+    }
+}
+
+// Nodo más lejano al conjunto actual; los inalcanzables tienen preferencia
+// para que cada componente reciba su landmark
+int farthest_node(const CsrGraph& graph, const std::vector<int>& chosen, SearchWorkspace& workspace) {
+    full_search(graph, chosen, false, workspace);
+    int best = -1;
+    double best_dist = -1.0;
+    for (size_t i = 0; i < graph.node_count(); ++i) {
+        int v = static_cast<int>(i);
+        if (std::find(chosen.begin(), chosen.end(), v) != chosen.end()) continue;
+        double d = workspace.distance(v);
+        if (d > best_dist) {
+            best_dist = d;
+            best = v;
+        }
+    }
+    return best;
+}
+
+} // namespace
+
+LandmarkIndex::LandmarkIndex(const CsrGraph& graph, size_t landmark_count,
+                             LandmarkSelection selection, size_t thread_count)
+    : node_count_(graph.node_count()) {
+    const size_t n = graph.node_count();
+    landmark_count = std::min(landmark_count, n);
+    if (landmark_count == 0) return;
+
+    SearchWorkspace workspace;
+    std::mt19937 random(static_cast<unsigned>(n)); // semilla fija: selección reproducible
+    std::vector<int> order;
+
+    // Distancias d(L, v) y d(v, L) de cada landmark, calculadas una sola vez
+    std::vector<std::vector<double>> from_dist, to_dist;
+    auto compute_tables = [&](size_t l, SearchWorkspace& ws) {
+        for (bool reverse : {false, true}) {
+            full_search(graph, {landmarks_[l]}, reverse, ws);
+            auto& table = reverse ? to_dist[l] : from_dist[l];
+            table.resize(n);
+            for (size_t v = 0; v < n; ++v) table[v] = ws.distance(static_cast<int>(v));
+        }
+    };
+
+    // Primer landmark: el nodo más lejano a un nodo aleatorio
+    int root = static_cast<int>(random() % n);
+    landmarks_.push_back(farthest_node(graph, {root}, workspace));
+
+    std::vector<double> size(n), root_lower(n);
+    std::vector<int> first_child(n), next_sibling(n);
+    while (landmarks_.size() < landmark_count) {
+        int next = -1;
+        if (selection == LandmarkSelection::AVOID) {
+            // Árbol de caminos mínimos desde una raíz aleatoria; cada nodo pesa
+            // lo que la cota actual subestima su distancia. Se desciende por el
+            // subárbol más pesado que no contiene landmarks hasta una hoja.
+            from_dist.resize(landmarks_.size());
+            to_dist.resize(landmarks_.size());
+            for (size_t l = 0; l < landmarks_.size(); ++l) {
+                if (from_dist[l].empty()) compute_tables(l, workspace);
+            }
+
+            root = static_cast<int>(random() % n);
+            full_search(graph, {root}, false, workspace, &order);
+
+            std::fill(root_lower.begin(), root_lower.end(), 0.0);
+            for (size_t l = 0; l < landmarks_.size(); ++l) {
+                for (int v : order) {
+                    double a = from_dist[l][v] - from_dist[l][root];
+                    double b = to_dist[l][root] - to_dist[l][v];
+                    if (std::isfinite(a)) root_lower[v] = std::max(root_lower[v], a);
+                    if (std::isfinite(b)) root_lower[v] = std::max(root_lower[v], b);
+                }
+            }
+
+            std::fill(first_child.begin(), first_child.end(), -1);
+            for (int v : order) {
+                int parent = workspace.parent(v);
+                if (parent >= 0) {
+                    next_sibling[v] = first_child[parent];
+                    first_child[parent] = v;
+                }
+            }
+            // Recorrido en orden inverso de asentamiento: hijos antes que padres.
+            // Un tamaño negativo marca un subárbol que ya contiene un landmark.
+            for (auto it = order.rbegin(); it != order.rend(); ++it) {
+                int v = *it;
+                bool has_landmark = std::find(landmarks_.begin(), landmarks_.end(), v) != landmarks_.end();
+                double total = std::max(0.0, workspace.distance(v) - root_lower[v]);
+                for (int c = first_child[v]; c >= 0 && !has_landmark; c = next_sibling[c]) {
+                    if (size[c] < 0.0) has_landmark = true;
+                    else total += size[c];
+                }
+                size[v] = has_landmark ? -1.0 : total;
+            }
+
+            if (size[root] > 0.0) {
+                int v = root;
+                while (true) {
+                    int heaviest = -1;
+                    for (int c = first_child[v]; c >= 0; c = next_sibling[c]) {
+                        if (size[c] > 0.0 && (heaviest < 0 || size[c] > size[heaviest])) heaviest = c;
+                    }
+                    if (heaviest < 0) break;
+                    v = heaviest;
+                }
+                next = v;
+            }
+        }
+        if (next < 0 || std::find(landmarks_.begin(), landmarks_.end(), next) != landmarks_.end()) {
+            next = farthest_node(graph, landmarks_, workspace);
+        }
+        if (next < 0) break;
+        landmarks_.push_back(next);
+    }
+
+    // Tablas que falten, en paralelo (una tarea por landmark)
+    const size_t k = landmarks_.size();
+    from_dist.resize(k);
+    to_dist.resize(k);
+    ThreadPool pool(thread_count);
+    std::vector<SearchWorkspace> workspaces(pool.size());
+    pool.parallel_for(k, [&](size_t l, size_t worker) {
+        if (from_dist[l].empty()) compute_tables(l, workspaces[worker]);
+    });
+
+    from_landmark_.resize(n * k);
+    to_landmark_.resize(n * k);
+    for (size_t v = 0; v < n; ++v) {
+        for (size_t l = 0; l < k; ++l) {
+            from_landmark_[v * k + l] = from_dist[l][v];
+            to_landmark_[v * k + l] = to_dist[l][v];
+        }
+    }
+}
+
+double LandmarkIndex::lower_bound(int from, int to) const {
+    const size_t k = landmarks_.size();
+    const double* from_l_v = &from_landmark_[static_cast<size_t>(from) * k];
+    const double* from_l_t = &from_landmark_[static_cast<size_t>(to) * k];
+    const double* to_v_l = &to_landmark_[static_cast<size_t>(from) * k];
+    const double* to_t_l = &to_landmark_[static_cast<size_t>(to) * k];
+
+    double bound = 0.0;
+    for (size_t l = 0; l < k; ++l) {
+        // d(v,t) >= d(L,t) - d(L,v)  y  d(v,t) >= d(v,L) - d(t,L).
+        // inf - finito = inf indica que t no es alcanzable desde v; inf - inf se ignora.
+        double forward = from_l_t[l] - from_l_v[l];
+        double backward = to_v_l[l] - to_t_l[l];
+        if (!std::isnan(forward)) bound = std::max(bound, forward);
+        if (!std::isnan(backward)) bound = std::max(bound, backward);
+    }
+    return bound;
+}
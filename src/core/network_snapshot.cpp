@@ -0,0 +1,443 @@
+#include "core/network_snapshot.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <type_traits>
+#include <unordered_map>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define URBAN_TRANSPORT_POSIX_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <process.h>
+#endif
+
+using namespace urban_transport;
+
+namespace {
+
+constexpr uint32_t SNAPSHOT_MAGIC = 0x534E5455; // "UTNS"
+constexpr uint32_t SNAPSHOT_VERSION = 2;
+
+// Bits de SnapshotHeader::flags
+constexpr uint64_t FLAG_ADJUSTED_WEIGHTS = 1; // pesos que no salen de la base de datos
+
+constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ULL;
+constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+enum Section : uint32_t {
+    NODE_IDS,
+    OFFSETS,
+    TARGETS,
+    WEIGHTS,
+    IN_OFFSETS,
+    IN_SOURCES,
+    IN_WEIGHTS,
+    LATITUDES,
+    LONGITUDES,
+    STOP_IDS,
+    STOP_OFFSETS,
+    ENTRY_ROUTES,
+    ENTRY_POSITIONS,
+    ROUTE_IDS,
+    ROUTE_OFFSETS,
+    ROUTE_SEQUENCE,
+    ROUTE_NAMES,
+    ROUTE_TYPES,
+    STRING_OFFSETS,
+    STRING_DATA,
+    SECTION_COUNT
+};
+
+// Desplazamiento y tamaño en bytes desde el inicio del fichero
+struct SectionEntry {
+    uint64_t offset;
+    uint64_t size;
+};
+
+struct SnapshotHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t fingerprint;
+    uint64_t flags;
+    uint64_t checksum; // de todo lo que sigue a la cabecera
+    uint64_t node_count;
+    uint64_t edge_count;
+    uint64_t stop_count;
+    uint64_t route_count;
+    uint64_t entry_count; // paradas de todas las rutas
+    uint64_t string_count;
+    SectionEntry sections[SECTION_COUNT];
+};
+
+// Contenido del fichero en memoria alineada a 8 bytes: mapeado con mmap
+// donde lo hay y leído entero en el resto de plataformas. Se libera cuando
+// deja de haber vistas sobre él.
+struct MappedFile {
+    const char* data = nullptr;
+    size_t size = 0;
+#ifdef URBAN_TRANSPORT_POSIX_MMAP
+    ~MappedFile() {
+        if (data) munmap(const_cast<char*>(data), size);
+    }
+#else
+    std::vector<uint64_t> buffer;
+#endif
+
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+};
+
+// nullptr si el fichero no existe o no llega a min_size bytes
+std::shared_ptr<MappedFile> map_file(const std::string& path, size_t min_size) {
+    auto file = std::make_shared<MappedFile>();
+#ifdef URBAN_TRANSPORT_POSIX_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(min_size) || info.st_size == 0) {
+        ::close(fd);
+        return nullptr;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) return nullptr;
+    file->data = static_cast<const char*>(address);
+    file->size = size;
+#else
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) return nullptr;
+    std::streamoff end = in.tellg();
+    if (end <= 0 || static_cast<uint64_t>(end) < min_size) return nullptr;
+    size_t size = static_cast<size_t>(end);
+    file->buffer.resize((size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    in.seekg(0);
+    if (!in.read(reinterpret_cast<char*>(file->buffer.data()), static_cast<std::streamsize>(size))) return nullptr;
+    file->data = reinterpret_cast<const char*>(file->buffer.data());
+    file->size = size;
+#endif
+    return file;
+}
+
+void mix(uint64_t& hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+}
+
+// FNV-1a sobre palabras de 64 bits; size es múltiplo de 8
+uint64_t checksum(const char* data, size_t size) {
+    uint64_t hash = FNV_OFFSET;
+    for (size_t i = 0; i < size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        hash ^= word;
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+template <typename T>
+void append_section(std::string& payload, SnapshotHeader& header, Section id,
+                    const T* values, size_t count) {
+    size_t bytes = count * sizeof(T);
+    header.sections[id] = {sizeof(SnapshotHeader) + payload.size(), bytes};
+    if (bytes > 0) payload.append(reinterpret_cast<const char*>(values), bytes);
+    payload.append((8 - payload.size() % 8) % 8, '\0');
+}
+
+template <typename T>
+const T* section(const char* data, Section id) {
+    const auto* header = reinterpret_cast<const SnapshotHeader*>(data);
+    return reinterpret_cast<const T*>(data + header->sections[id].offset);
+}
+
+// Desplazamientos CSR: empiezan en 0, no decrecen y terminan en total
+bool valid_offsets(const uint32_t* offsets, uint64_t count, uint64_t total) {
+    if (offsets[0] != 0 || offsets[count] != total) return false;
+    for (uint64_t i = 0; i < count; ++i) {
+        if (offsets[i] > offsets[i + 1]) return false;
+    }
+    return true;
+}
+
+bool valid_indices(const int* values, uint64_t count, uint64_t limit) {
+    for (uint64_t i = 0; i < count; ++i) {
+        if (values[i] < 0 || static_cast<uint64_t>(values[i]) >= limit) return false;
+    }
+    return true;
+}
+
+bool valid_indices(const uint32_t* values, uint64_t count, uint64_t limit) {
+    for (uint64_t i = 0; i < count; ++i) {
+        if (values[i] >= limit) return false;
+    }
+    return true;
+}
+
+// Comprueba que las secciones caben en el fichero con el tamaño que indican
+// los contadores y que los índices internos están en rango, para que un
+// fichero manipulado no provoque accesos fuera del mapeo
+bool valid_layout(const char* data, size_t file_size) {
+    const auto& h = *reinterpret_cast<const SnapshotHeader*>(data);
+    const uint64_t limit = std::numeric_limits<uint32_t>::max();
+    if (h.node_count >= limit || h.edge_count >= limit || h.stop_count >= limit ||
+        h.route_count >= limit || h.entry_count >= limit || h.string_count >= limit) {
+        return false;
+    }
+
+    const uint64_t expected[SECTION_COUNT] = {
+        h.node_count * sizeof(int),           (h.node_count + 1) * sizeof(uint32_t),
+        h.edge_count * sizeof(int),           h.edge_count * sizeof(double),
+        (h.node_count + 1) * sizeof(uint32_t), h.edge_count * sizeof(int),
+        h.edge_count * sizeof(double),        h.node_count * sizeof(double),
+        h.node_count * sizeof(double),        h.stop_count * sizeof(int),
+        (h.stop_count + 1) * sizeof(uint32_t), h.entry_count * sizeof(int),
+        h.entry_count * sizeof(uint32_t),     h.route_count * sizeof(int),
+        (h.route_count + 1) * sizeof(uint32_t), h.entry_count * sizeof(int),
+        h.route_count * sizeof(uint32_t),     h.route_count * sizeof(uint32_t),
+        (h.string_count + 1) * sizeof(uint32_t), 0
+    };
+    for (uint32_t id = 0; id < SECTION_COUNT; ++id) {
+        const SectionEntry& entry = h.sections[id];
+        if (id != STRING_DATA && entry.size != expected[id]) return false;
+        if (entry.offset % 8 != 0 || entry.offset < sizeof(SnapshotHeader)) return false;
+        if (entry.size > file_size || entry.offset > file_size - entry.size) return false;
+    }
+
+    const uint32_t* strings = section<uint32_t>(data, STRING_OFFSETS);
+    return valid_offsets(section<uint32_t>(data, OFFSETS), h.node_count, h.edge_count) &&
+           valid_offsets(section<uint32_t>(data, IN_OFFSETS), h.node_count, h.edge_count) &&
+           valid_indices(section<int>(data, TARGETS), h.edge_count, h.node_count) &&
+           valid_indices(section<int>(data, IN_SOURCES), h.edge_count, h.node_count) &&
+           valid_offsets(section<uint32_t>(data, STOP_OFFSETS), h.stop_count, h.entry_count) &&
+           valid_offsets(section<uint32_t>(data, ROUTE_OFFSETS), h.route_count, h.entry_count) &&
+           valid_offsets(strings, h.string_count, h.sections[STRING_DATA].size) &&
+           valid_indices(section<uint32_t>(data, ROUTE_NAMES), h.route_count, h.string_count) &&
+           valid_indices(section<uint32_t>(data, ROUTE_TYPES), h.route_count, h.string_count);
+}
+
+// Temporal propio de cada escritor (proceso e hilo): dos procesos que
+// reconstruyen a la vez no escriben en el mismo fichero
+std::string temporary_path(const std::string& path) {
+    static std::atomic<unsigned> counter{0};
+#ifdef URBAN_TRANSPORT_POSIX_MMAP
+    long pid = static_cast<long>(getpid());
+#else
+    long pid = static_cast<long>(_getpid());
+#endif
+    return path + "." + std::to_string(pid) + "." + std::to_string(counter.fetch_add(1)) + ".tmp";
+}
+
+bool mix_file_stat(uint64_t& hash, const std::string& path) {
+    std::error_code error;
+    auto size = std::filesystem::file_size(path, error);
+    if (error) return false;
+    auto modified = std::filesystem::last_write_time(path, error);
+    if (error) return false;
+    int64_t values[2] = {static_cast<int64_t>(size),
+                         static_cast<int64_t>(modified.time_since_epoch().count())};
+    mix(hash, values, sizeof(values));
+    return true;
+}
+
+} // namespace
+
+uint64_t urban_transport::database_fingerprint(const std::string& db_path) {
+    // Cabecera de SQLite: "SQLite format 3\0"; bytes 24-27 contador de
+    // cambios y 28-31 número de páginas
+    char header[100];
+    std::ifstream in(db_path, std::ios::binary);
+    if (!in.read(header, sizeof(header))) return 0;
+    if (std::memcmp(header, "SQLite format 3", 16) != 0) return 0;
+
+    uint64_t hash = FNV_OFFSET;
+    mix(hash, header + 24, 8);
+    if (!mix_file_stat(hash, db_path)) return 0;
+    // En modo WAL las escrituras no tocan el fichero principal hasta el
+    // checkpoint: el diario también forma parte de la huella
+    mix_file_stat(hash, db_path + "-wal");
+    return hash != 0 ? hash : 1;
+}
+
+bool NetworkSnapshot::write(const std::string& path, uint64_t fingerprint, const CsrGraph& graph,
+                            const std::vector<SnapshotRoute>& routes, bool adjusted_weights) {
+    std::unordered_map<int, std::vector<int>> route_stops;
+    std::map<int, const SnapshotRoute*> by_id;
+    for (const auto& route : routes) {
+        route_stops[route.id] = route.stop_ids;
+        by_id[route.id] = &route;
+    }
+    StopRouteIndex index(route_stops);
+
+    // Nombres y tipos internados: cada cadena distinta se guarda una vez
+    std::unordered_map<std::string, uint32_t> interned;
+    std::vector<uint32_t> string_offsets{0};
+    std::string string_data;
+    auto intern = [&](const std::string& value) {
+        auto it = interned.find(value);
+        if (it != interned.end()) return it->second;
+        uint32_t id = static_cast<uint32_t>(interned.size());
+        interned.emplace(value, id);
+        string_data += value;
+        string_offsets.push_back(static_cast<uint32_t>(string_data.size()));
+        return id;
+    };
+    std::vector<uint32_t> names;
+    std::vector<uint32_t> types;
+    for (int route_id : index.route_ids_) {
+        names.push_back(intern(by_id.at(route_id)->name));
+        types.push_back(intern(by_id.at(route_id)->transport_type));
+    }
+
+    SnapshotHeader header{};
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = SNAPSHOT_VERSION;
+    header.fingerprint = fingerprint;
+    header.flags = adjusted_weights ? FLAG_ADJUSTED_WEIGHTS : 0;
+    header.node_count = graph.node_count();
+    header.edge_count = graph.edge_count();
+    header.stop_count = index.stop_ids_.size();
+    header.route_count = index.route_ids_.size();
+    header.entry_count = index.route_sequence_.size();
+    header.string_count = interned.size();
+
+    const size_t n = graph.node_count();
+    const size_t e = graph.edge_count();
+    // Un grafo vacío no tiene arrays: sus desplazamientos se guardan como {0}
+    const uint32_t zero = 0;
+    std::string payload;
+    append_section(payload, header, NODE_IDS, graph.node_ids_, n);
+    append_section(payload, header, OFFSETS, n > 0 ? graph.offsets_ : &zero, n + 1);
+    append_section(payload, header, TARGETS, graph.targets_, e);
+    append_section(payload, header, WEIGHTS, graph.weights_, e);
+    append_section(payload, header, IN_OFFSETS, n > 0 ? graph.in_offsets_ : &zero, n + 1);
+    append_section(payload, header, IN_SOURCES, graph.in_sources_, e);
+    append_section(payload, header, IN_WEIGHTS, graph.in_weights_, e);
+    append_section(payload, header, LATITUDES, graph.latitudes_, n);
+    append_section(payload, header, LONGITUDES, graph.longitudes_, n);
+    append_section(payload, header, STOP_IDS, index.stop_ids_.data(), index.stop_ids_.size());
+    append_section(payload, header, STOP_OFFSETS, index.stop_offsets_.data(), index.stop_offsets_.size());
+    append_section(payload, header, ENTRY_ROUTES, index.entry_routes_.data(), index.entry_routes_.size());
+    append_section(payload, header, ENTRY_POSITIONS, index.entry_positions_.data(),
+                   index.entry_positions_.size());
+    append_section(payload, header, ROUTE_IDS, index.route_ids_.data(), index.route_ids_.size());
+    append_section(payload, header, ROUTE_OFFSETS, index.route_offsets_.data(), index.route_offsets_.size());
+    append_section(payload, header, ROUTE_SEQUENCE, index.route_sequence_.data(),
+                   index.route_sequence_.size());
+    append_section(payload, header, ROUTE_NAMES, names.data(), names.size());
+    append_section(payload, header, ROUTE_TYPES, types.data(), types.size());
+    append_section(payload, header, STRING_OFFSETS, string_offsets.data(), string_offsets.size());
+    append_section(payload, header, STRING_DATA, string_data.data(), string_data.size());
+    header.checksum = checksum(payload.data(), payload.size());
+
+    std::string temporary = temporary_path(path);
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+        if (!out.flush()) {
+            out.close();
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+    // filesystem::rename sustituye el destino también en Windows
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool NetworkSnapshot::open(const std::string& path, uint64_t expected_fingerprint) {
+    auto mapping = map_file(path, sizeof(SnapshotHeader));
+    if (!mapping) return false;
+    const char* data = mapping->data;
+    const size_t size = mapping->size;
+    const auto& header = *reinterpret_cast<const SnapshotHeader*>(data);
+    if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION) return false;
+    if (expected_fingerprint == 0 || header.fingerprint != expected_fingerprint) return false;
+    if (size % 8 != 0) return false;
+    if (checksum(data + sizeof(SnapshotHeader), size - sizeof(SnapshotHeader)) != header.checksum) return false;
+    if (!valid_layout(data, size)) return false;
+
+    CsrGraph graph;
+    graph.owner_ = mapping;
+    graph.node_count_ = header.node_count;
+    graph.edge_count_ = header.edge_count;
+    graph.node_ids_ = section<int>(data, NODE_IDS);
+    graph.offsets_ = section<uint32_t>(data, OFFSETS);
+    graph.targets_ = section<int>(data, TARGETS);
+    graph.weights_ = section<double>(data, WEIGHTS);
+    graph.in_offsets_ = section<uint32_t>(data, IN_OFFSETS);
+    graph.in_sources_ = section<int>(data, IN_SOURCES);
+    graph.in_weights_ = section<double>(data, IN_WEIGHTS);
+    graph.latitudes_ = section<double>(data, LATITUDES);
+    graph.longitudes_ = section<double>(data, LONGITUDES);
+
+    graph_ = std::move(graph);
+    mapping_ = std::move(mapping);
+    data_ = data;
+    route_count_ = header.route_count;
+    adjusted_weights_ = (header.flags & FLAG_ADJUSTED_WEIGHTS) != 0;
+    return true;
+}
+
+std::vector<SnapshotRoute> NetworkSnapshot::routes() const {
+    std::vector<SnapshotRoute> routes;
+    if (!data_) return routes;
+
+    const int* ids = section<int>(data_, ROUTE_IDS);
+    const uint32_t* offsets = section<uint32_t>(data_, ROUTE_OFFSETS);
+    const int* sequence = section<int>(data_, ROUTE_SEQUENCE);
+    const uint32_t* names = section<uint32_t>(data_, ROUTE_NAMES);
+    const uint32_t* types = section<uint32_t>(data_, ROUTE_TYPES);
+    const uint32_t* string_offsets = section<uint32_t>(data_, STRING_OFFSETS);
+    const char* strings = section<char>(data_, STRING_DATA);
+    auto text = [&](uint32_t id) {
+        return std::string(strings + string_offsets[id], string_offsets[id + 1] - string_offsets[id]);
+    };
+
+    routes.reserve(route_count_);
+    for (size_t r = 0; r < route_count_; ++r) {
+        routes.push_back({ids[r], text(names[r]), text(types[r]),
+                          std::vector<int>(sequence + offsets[r], sequence + offsets[r + 1])});
+    }
+    return routes;
+}
+
+StopRouteIndex NetworkSnapshot::route_index() const {
+    StopRouteIndex index;
+    if (!data_) return index;
+
+    const auto& header = *reinterpret_cast<const SnapshotHeader*>(data_);
+    auto copy = [&](auto& target, Section id, uint64_t count) {
+        using T = typename std::decay_t<decltype(target)>::value_type;
+        const T* values = section<T>(data_, id);
+        target.assign(values, values + count);
+    };
+    copy(index.stop_ids_, STOP_IDS, header.stop_count);
+    copy(index.stop_offsets_, STOP_OFFSETS, header.stop_count + 1);
+    copy(index.entry_routes_, ENTRY_ROUTES, header.entry_count);
+    copy(index.entry_positions_, ENTRY_POSITIONS, header.entry_count);
+    copy(index.route_ids_, ROUTE_IDS, header.route_count);
+    copy(index.route_offsets_, ROUTE_OFFSETS, header.route_count + 1);
+    copy(index.route_sequence_, ROUTE_SEQUENCE, header.entry_count);
+    return index;
+}
@@ -0,0 +1,65 @@
+#include "core/search_workspace.h"
+#include <algorithm>
+#include <limits>
+
+using namespace urban_transport;
+
+namespace {
+
+struct HeapGreater {
+    bool operator()(const SearchWorkspace::HeapEntry& a, const SearchWorkspace::HeapEntry& b) const {
+        return a.key > b.key;
+    }
+};
+
+} // namespace
+
+void SearchWorkspace::reset(size_t node_count) {
+    if (stamps_.size() < node_count) {
+        stamps_.resize(node_count, 0);
+        settled_stamps_.resize(node_count, 0);
+        distances_.resize(node_count);
+        parents_.resize(node_count);
+    }
+
+    if (epoch_ == std::numeric_limits<uint32_t>::max()) {
+        // Desbordamiento de la época: se limpian los sellos una sola vez
+        std::fill(stamps_.begin(), stamps_.end(), 0);
+        std::fill(settled_stamps_.begin(), settled_stamps_.end(), 0);
+        epoch_ = 0;
+    }
+    ++epoch_;
+    heap_.clear();
+}
+
+double SearchWorkspace::distance(int node) const {
+    return reached(node) ? distances_[node] : std::numeric_limits<double>::infinity();
+}
+
+void SearchWorkspace::set_distance(int node, double distance, int parent) {
+    stamps_[node] = epoch_;
+    distances_[node] = distance;
+    parents_[node] = parent;
+}
+
+void SearchWorkspace::push(double key, int node) {
+    heap_.push_back({key, node});
+    std::push_heap(heap_.begin(), heap_.end(), HeapGreater());
+}
+
+SearchWorkspace::HeapEntry SearchWorkspace::pop() {
+    std::pop_heap(heap_.begin(), heap_.end(), HeapGreater());
+    HeapEntry entry = heap_.back();
+    heap_.pop_back();
+    return entry;
+}
+
+SearchWorkspace& SearchWorkspace::for_current_thread() {
+    thread_local SearchWorkspace workspace;
+    return workspace;
+}
+
+BidirectionalWorkspace& BidirectionalWorkspace::for_current_thread() {
+    thread_local BidirectionalWorkspace workspace;
+    return workspace;
+}
@@ -0,0 +1,33 @@
+#include "core/service_time.h"
+#include <cstdio>
+
+using namespace urban_transport;
+
+bool urban_transport::parse_service_time(std::string_view text, int& seconds) {
+    int fields[3] = {0, 0, 0};
+    int field = 0;
+    int digits = 0;
+    for (char c : text) {
+        if (c >= '0' && c <= '9') {
+            if (++digits > (field == 0 ? 3 : 2)) return false;
+            fields[field] = fields[field] * 10 + (c - '0');
+        } else if (c == ':' && digits > 0 && field < 2) {
+            ++field;
+            digits = 0;
+        } else {
+            return false;
+        }
+    }
+    if (digits == 0 || field == 0) return false;
+    if (fields[1] > 59 || fields[2] > 59) return false;
+
+    seconds = fields[0] * 3600 + fields[1] * 60 + fields[2];
+    return true;
+}
+
+std::string urban_transport::format_service_time(int seconds) {
+    char buffer[16];
+    std::snprintf(buffer, sizeof(buffer), "%02d:%02d:%02d",
+                  seconds / 3600, (seconds / 60) % 60, seconds % 60);
+    return buffer;
+}
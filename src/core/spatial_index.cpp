@@ -0,0 +1,141 @@
+#include "core/spatial_index.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace urban_transport;
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+constexpr double EARTH_RADIUS_KM = 6371.0;
+constexpr double KM_PER_DEGREE = EARTH_RADIUS_KM * PI / 180.0;
+// Ninguna distancia Haversine supera media circunferencia
+constexpr double MAX_DISTANCE_KM = EARTH_RADIUS_KM * PI;
+
+bool closer(const SpatialMatch& a, const SpatialMatch& b) {
+    return a.distance_km != b.distance_km ? a.distance_km < b.distance_km : a.id < b.id;
+}
+
+} // namespace
+
+SpatialIndex::SpatialIndex(double cell_size_km)
+    : cell_degrees_((cell_size_km > 0.0 ? cell_size_km : 0.5) / KM_PER_DEGREE) {}
+
+void SpatialIndex::clear() {
+    cells_.clear();
+    positions_.clear();
+}
+
+int64_t SpatialIndex::cell_key(int64_t row, int64_t column) const {
+    // En unsigned: desplazar un int64_t negativo (latitudes del sur) es UB
+    uint64_t high = static_cast<uint64_t>(static_cast<uint32_t>(row)) << 32;
+    return static_cast<int64_t>(high | static_cast<uint32_t>(column));
+}
+
+int64_t SpatialIndex::row_of(double latitude) const {
+    return static_cast<int64_t>(std::floor(latitude / cell_degrees_));
+}
+
+int64_t SpatialIndex::column_of(double longitude) const {
+    return static_cast<int64_t>(std::floor(longitude / cell_degrees_));
+}
+
+void SpatialIndex::insert(int id, double latitude, double longitude) {
+    remove(id);
+    positions_[id] = {latitude, longitude};
+    Cell& cell = cells_[cell_key(row_of(latitude), column_of(longitude))];
+    cell.ids.push_back(id);
+    cell.coordinates.push_back(latitude, longitude);
+}
+
+bool SpatialIndex::remove(int id) {
+    auto it = positions_.find(id);
+    if (it == positions_.end()) return false;
+
+    int64_t key = cell_key(row_of(it->second.first), column_of(it->second.second));
+    auto cell = cells_.find(key);
+    if (cell != cells_.end()) {
+        auto& ids = cell->second.ids;
+        auto slot = std::find(ids.begin(), ids.end(), id);
+        if (slot != ids.end()) {
+            size_t index = static_cast<size_t>(slot - ids.begin());
+            ids[index] = ids.back();
+            ids.pop_back();
+            cell->second.coordinates.swap_remove(index);
+        }
+        if (ids.empty()) cells_.erase(cell);
+    }
+    positions_.erase(it);
+    return true;
+}
+
+void SpatialIndex::collect(const Cell& cell, double latitude, double longitude,
+                           double radius_km, std::vector<SpatialMatch>& matches) const {
+    thread_local std::vector<double> distances;
+    distances.resize(cell.ids.size());
+    haversine_batch(latitude, longitude, cell.coordinates, distances.data());
+    for (size_t i = 0; i < cell.ids.size(); ++i) {
+        if (distances[i] <= radius_km) matches.push_back({cell.ids[i], distances[i]});
+    }
+}
+
+std::vector<SpatialMatch> SpatialIndex::within_radius(double latitude, double longitude,
+                                                      double radius_km) const {
+    std::vector<SpatialMatch> matches;
+    if (radius_km < 0.0 || positions_.empty()) return matches;
+
+    // Caja que contiene el círculo: en latitud es exacta; en longitud se usa
+    // asin(sin(r) / cos(lat)), que cubre el punto de máxima separación
+    double radius_rad = std::min(radius_km, MAX_DISTANCE_KM) / EARTH_RADIUS_KM;
+    double lat_span = radius_km / KM_PER_DEGREE;
+    double min_lat = latitude - lat_span;
+    double max_lat = latitude + lat_span;
+
+    bool all_columns = min_lat <= -90.0 || max_lat >= 90.0;
+    double lon_span = 0.0;
+    if (!all_columns) {
+        double ratio = std::sin(radius_rad) / std::cos(latitude * PI / 180.0);
+        all_columns = radius_rad >= PI / 2 || ratio >= 1.0;
+        if (!all_columns) lon_span = std::asin(ratio) * 180.0 / PI;
+    }
+    // Sin tratamiento del antimeridiano: se recorre toda la longitud
+    if (longitude - lon_span < -180.0 || longitude + lon_span > 180.0) all_columns = true;
+
+    int64_t row_begin = row_of(std::max(min_lat, -90.0));
+    int64_t row_end = row_of(std::min(max_lat, 90.0));
+    int64_t column_begin = column_of(longitude - lon_span);
+    int64_t column_end = column_of(longitude + lon_span);
+
+    double cell_count = static_cast<double>(row_end - row_begin + 1) *
+                        static_cast<double>(column_end - column_begin + 1);
+    if (all_columns || cell_count > static_cast<double>(cells_.size())) {
+        // Más celdas en la caja que celdas ocupadas: se recorren las ocupadas
+        for (const auto& [key, cell] : cells_) collect(cell, latitude, longitude, radius_km, matches);
+    } else {
+        for (int64_t row = row_begin; row <= row_end; ++row) {
+            for (int64_t column = column_begin; column <= column_end; ++column) {
+                auto cell = cells_.find(cell_key(row, column));
+                if (cell != cells_.end()) collect(cell->second, latitude, longitude, radius_km, matches);
+            }
+        }
+    }
+
+    std::sort(matches.begin(), matches.end(), closer);
+    return matches;
+}
+
+std::vector<SpatialMatch> SpatialIndex::nearest(double latitude, double longitude, size_t k) const {
+    if (k == 0 || positions_.empty()) return {};
+
+    // Radio creciente: en cuanto el círculo contiene k puntos, contiene los
+    // k más cercanos
+    double radius_km = cell_degrees_ * KM_PER_DEGREE;
+    while (true) {
+        auto matches = within_radius(latitude, longitude, radius_km);
+        if (matches.size() >= k || matches.size() == positions_.size() || radius_km >= MAX_DISTANCE_KM) {
+            if (matches.size() > k) matches.resize(k);
+            return matches;
+        }
+        radius_km *= 2.0;
+    }
+}
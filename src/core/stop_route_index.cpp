@@ -0,0 +1,92 @@
+#include "core/stop_route_index.h"
+#include <algorithm>
+
+using namespace urban_transport;
+
+StopRouteIndex::StopRouteIndex(const std::unordered_map<int, std::vector<int>>& route_stops) {
+    for (const auto& [route_id, stops] : route_stops) {
+        route_ids_.push_back(route_id);
+        stop_ids_.insert(stop_ids_.end(), stops.begin(), stops.end());
+    }
+    std::sort(route_ids_.begin(), route_ids_.end());
+    std::sort(stop_ids_.begin(), stop_ids_.end());
+    stop_ids_.erase(std::unique(stop_ids_.begin(), stop_ids_.end()), stop_ids_.end());
+
+    // Secuencias por ruta, en orden de id de ruta
+    route_offsets_.reserve(route_ids_.size() + 1);
+    route_offsets_.push_back(0);
+    for (int route_id : route_ids_) {
+        const auto& stops = route_stops.at(route_id);
+        route_sequence_.insert(route_sequence_.end(), stops.begin(), stops.end());
+        route_offsets_.push_back(static_cast<uint32_t>(route_sequence_.size()));
+    }
+
+    // Transpuesta: como las rutas se recorren en orden, cada lista de parada
+    // queda ordenada por id de ruta y posición
+    stop_offsets_.assign(stop_ids_.size() + 1, 0);
+    for (int stop : route_sequence_) ++stop_offsets_[stop_index(stop) + 1];
+    for (size_t i = 0; i < stop_ids_.size(); ++i) stop_offsets_[i + 1] += stop_offsets_[i];
+
+    entry_routes_.resize(route_sequence_.size());
+    entry_positions_.resize(route_sequence_.size());
+    std::vector<uint32_t> cursor(stop_offsets_.begin(), stop_offsets_.end() - 1);
+    for (size_t r = 0; r < route_ids_.size(); ++r) {
+        for (uint32_t i = route_offsets_[r]; i < route_offsets_[r + 1]; ++i) {
+            uint32_t slot = cursor[stop_index(route_sequence_[i])]++;
+            entry_routes_[slot] = route_ids_[r];
+            entry_positions_[slot] = i - route_offsets_[r];
+        }
+    }
+}
+
+int StopRouteIndex::stop_index(int stop_id) const {
+    auto it = std::lower_bound(stop_ids_.begin(), stop_ids_.end(), stop_id);
+    if (it == stop_ids_.end() || *it != stop_id) return -1;
+    return static_cast<int>(it - stop_ids_.begin());
+}
+
+std::vector<int> StopRouteIndex::routes_through(int stop_id) const {
+    std::vector<int> routes;
+    int stop = stop_index(stop_id);
+    if (stop < 0) return routes;
+
+    for (uint32_t e = stop_offsets_[stop]; e < stop_offsets_[stop + 1]; ++e) {
+        // Una ruta circular puede pasar dos veces por la misma parada
+        if (routes.empty() || routes.back() != entry_routes_[e]) routes.push_back(entry_routes_[e]);
+    }
+    return routes;
+}
+
+std::vector<int> StopRouteIndex::direct_routes(int from_stop, int to_stop) const {
+    std::vector<int> routes;
+    int from = stop_index(from_stop);
+    int to = stop_index(to_stop);
+    if (from < 0 || to < 0) return routes;
+
+    uint32_t a = stop_offsets_[from], a_end = stop_offsets_[from + 1];
+    uint32_t b = stop_offsets_[to], b_end = stop_offsets_[to + 1];
+    while (a < a_end && b < b_end) {
+        if (entry_routes_[a] < entry_routes_[b]) {
+            ++a;
+        } else if (entry_routes_[b] < entry_routes_[a]) {
+            ++b;
+        } else {
+            // Misma ruta: basta la primera aparición de from y la última de to
+            int route = entry_routes_[a];
+            uint32_t first_from = entry_positions_[a];
+            uint32_t last_to = entry_positions_[b];
+            while (a < a_end && entry_routes_[a] == route) ++a;
+            while (b < b_end && entry_routes_[b] == route) last_to = entry_positions_[b++];
+            if (first_from < last_to) routes.push_back(route);
+        }
+    }
+    return routes;
+}
+
+std::vector<int> StopRouteIndex::route_stops(int route_id) const {
+    auto it = std::lower_bound(route_ids_.begin(), route_ids_.end(), route_id);
+    if (it == route_ids_.end() || *it != route_id) return {};
+    size_t r = static_cast<size_t>(it - route_ids_.begin());
+    return std::vector<int>(route_sequence_.begin() + route_offsets_[r],
+                            route_sequence_.begin() + route_offsets_[r + 1]);
+}
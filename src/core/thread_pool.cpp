@@ -0,0 +1,122 @@
+#include "core/thread_pool.h"
+#include <algorithm>
+#include <chrono>
+
+using namespace urban_transport;
+
+namespace {
+
+// Espera sin plazo: equivale a condition.wait(lock, ready), sin despertares
+// periódicos. Se usa wait_until porque wait(unique_lock&) de libstdc++ 12
+// exige GLIBCXX_3.4.30 y no todos los runtimes con los que se enlaza lo
+// tienen. Todo cambio de stopping_, generation_ o active_workers_ se hace y
+// se notifica con mutex_ tomado, así que no se pierden avisos.
+template <typename Predicate>
+void wait_until_ready(std::condition_variable& condition, std::unique_lock<std::mutex>& lock,
+                      Predicate ready) {
+    condition.wait_until(lock, std::chrono::steady_clock::time_point::max(), ready);
+}
+
+} // namespace
+
+ThreadPool::ThreadPool(size_t thread_count) {
+    if (thread_count == 0) thread_count = std::thread::hardware_concurrency();
+    if (thread_count == 0) thread_count = 1;
+
+    ranges_.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) ranges_.push_back(std::make_unique<WorkRange>());
+
+    workers_.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        workers_.emplace_back(&ThreadPool::worker_loop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        work_ready_.notify_all();
+    }
+    for (auto& worker : workers_) worker.join();
+}
+
+void ThreadPool::parallel_for(size_t count, const Task& task) {
+    if (count == 0) return;
+
+    // Un único lote en vuelo: los llamantes concurrentes esperan su turno
+    std::lock_guard<std::mutex> submit_lock(submit_mutex_);
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    const size_t threads = workers_.size();
+    for (size_t w = 0; w < threads; ++w) {
+        std::lock_guard<std::mutex> range_lock(ranges_[w]->mutex);
+        ranges_[w]->begin = count * w / threads;
+        ranges_[w]->end = count * (w + 1) / threads;
+    }
+    task_ = &task;
+    active_workers_ = threads;
+    ++generation_;
+    work_ready_.notify_all();
+
+    wait_until_ready(work_done_, lock, [this]() { return active_workers_ == 0; });
+    task_ = nullptr;
+}
+
+bool ThreadPool::take_next(size_t worker, size_t& index) {
+    WorkRange& range = *ranges_[worker];
+    std::lock_guard<std::mutex> lock(range.mutex);
+    if (range.begin >= range.end) return false;
+    index = range.begin++;
+    return true;
+}
+
+bool ThreadPool::steal(size_t thief) {
+    const size_t threads = workers_.size();
+    for (size_t offset = 1; offset < threads; ++offset) {
+        WorkRange& victim = *ranges_[(thief + offset) % threads];
+        size_t begin, end;
+        {
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            size_t remaining = victim.end - std::min(victim.begin, victim.end);
+            if (remaining == 0) continue;
+            size_t middle = victim.end - (remaining + 1) / 2;
+            begin = middle;
+            end = victim.end;
+            victim.end = middle;
+        }
+        WorkRange& own = *ranges_[thief];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        own.begin = begin;
+        own.end = end;
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::worker_loop(size_t worker) {
+    unsigned long seen_generation = 0;
+    while (true) {
+        const Task* task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wait_until_ready(work_ready_, lock, [&]() { return stopping_ || generation_ != seen_generation; });
+            if (stopping_) return;
+            seen_generation = generation_;
+            task = task_;
+        }
+
+        // Se agota el rango propio y luego se roba hasta que no quede trabajo
+        size_t index;
+        while (true) {
+            if (take_next(worker, index)) {
+                (*task)(index, worker);
+            } else if (!steal(worker)) {
+                break;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--active_workers_ == 0) work_done_.notify_one();
+    }
+}
@@ -0,0 +1,107 @@
+#include "core/timetable.h"
+#include <algorithm>
+#include <map>
+
+using namespace urban_transport;
+
+namespace {
+
+// Un viaje es válido si tiene al menos un tramo y sus horas no retroceden
+bool valid_trip(const ScheduledTrip& trip) {
+    if (trip.stop_ids.size() < 2 || trip.stop_ids.size() != trip.times.size()) return false;
+    for (size_t i = 0; i < trip.times.size(); ++i) {
+        if (trip.times[i] == NO_SERVICE_TIME) return false;
+        if (i > 0 && trip.times[i] < trip.times[i - 1]) return false;
+    }
+    return true;
+}
+
+// a no adelanta a b: b pasa por cada parada a la misma hora o después
+bool precedes(const ScheduledTrip& a, const ScheduledTrip& b) {
+    for (size_t i = 0; i < a.times.size(); ++i) {
+        if (b.times[i] < a.times[i]) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+Timetable::Timetable(const std::vector<ScheduledTrip>& trips) {
+    // Viajes agrupados por secuencia de paradas
+    std::map<std::vector<int>, std::vector<const ScheduledTrip*>> patterns;
+    for (const auto& trip : trips) {
+        if (!valid_trip(trip)) continue;
+        patterns[trip.stop_ids].push_back(&trip);
+        stop_ids_.insert(stop_ids_.end(), trip.stop_ids.begin(), trip.stop_ids.end());
+    }
+    std::sort(stop_ids_.begin(), stop_ids_.end());
+    stop_ids_.erase(std::unique(stop_ids_.begin(), stop_ids_.end()), stop_ids_.end());
+
+    route_stop_offsets_.push_back(0);
+    route_trip_offsets_.push_back(0);
+    route_time_offsets_.push_back(0);
+
+    for (auto& [sequence, members] : patterns) {
+        std::sort(members.begin(), members.end(), [](const ScheduledTrip* a, const ScheduledTrip* b) {
+            return a->times.front() != b->times.front() ? a->times.front() < b->times.front()
+                                                        : a->trip_id < b->trip_id;
+        });
+
+        // Un viaje que adelanta a otro abre un recorrido nuevo; así cada
+        // recorrido queda ordenado por hora en todas sus posiciones
+        std::vector<std::vector<const ScheduledTrip*>> routes;
+        for (const ScheduledTrip* trip : members) {
+            auto fits = std::find_if(routes.begin(), routes.end(), [&](const auto& route) {
+                return precedes(*route.back(), *trip);
+            });
+            if (fits == routes.end()) routes.emplace_back(1, trip);
+            else fits->push_back(trip);
+        }
+
+        for (const auto& route : routes) {
+            for (int stop : sequence) route_stops_.push_back(index_of(stop));
+            for (const ScheduledTrip* trip : route) {
+                trip_ids_.push_back(trip->trip_id);
+                stop_times_.insert(stop_times_.end(), trip->times.begin(), trip->times.end());
+            }
+            route_stop_offsets_.push_back(static_cast<uint32_t>(route_stops_.size()));
+            route_trip_offsets_.push_back(static_cast<uint32_t>(trip_ids_.size()));
+            route_time_offsets_.push_back(static_cast<uint32_t>(stop_times_.size()));
+        }
+    }
+
+    // Índice parada -> (recorrido, posición)
+    const size_t routes = route_count();
+    stop_route_offsets_.assign(stop_ids_.size() + 1, 0);
+    for (int stop : route_stops_) ++stop_route_offsets_[stop + 1];
+    for (size_t i = 0; i < stop_ids_.size(); ++i) stop_route_offsets_[i + 1] += stop_route_offsets_[i];
+
+    stop_routes_.resize(route_stops_.size());
+    stop_route_positions_.resize(route_stops_.size());
+    std::vector<uint32_t> cursor(stop_route_offsets_.begin(), stop_route_offsets_.end() - 1);
+    for (size_t r = 0; r < routes; ++r) {
+        for (uint32_t i = route_stop_offsets_[r]; i < route_stop_offsets_[r + 1]; ++i) {
+            uint32_t slot = cursor[route_stops_[i]]++;
+            stop_routes_[slot] = static_cast<int>(r);
+            stop_route_positions_[slot] = i - route_stop_offsets_[r];
+        }
+    }
+}
+
+int Timetable::index_of(int stop_id) const {
+    auto it = std::lower_bound(stop_ids_.begin(), stop_ids_.end(), stop_id);
+    if (it == stop_ids_.end() || *it != stop_id) return -1;
+    return static_cast<int>(it - stop_ids_.begin());
+}
+
+int Timetable::earliest_trip(int route, size_t position, int time) const {
+    // Los viajes del recorrido no se adelantan: búsqueda binaria por columna
+    size_t low = 0;
+    size_t high = route_trip_count(route);
+    while (low < high) {
+        size_t middle = (low + high) / 2;
+        if (stop_time(route, middle, position) < time) low = middle + 1;
+        else high = middle;
+    }
+    return low < route_trip_count(route) ? static_cast<int>(low) : -1;
+}
@@ -0,0 +1,100 @@
+#include "core/trip_interval_index.h"
+#include <algorithm>
+#include <unordered_set>
+
+using namespace urban_transport;
+
+namespace {
+
+constexpr int SECONDS_PER_DAY = 24 * 3600;
+
+} // namespace
+
+TripIntervalIndex::TripIntervalIndex(std::vector<TripInterval> intervals) {
+    std::sort(intervals.begin(), intervals.end(), [](const TripInterval& a, const TripInterval& b) {
+        return a.start != b.start ? a.start < b.start : a.trip_id < b.trip_id;
+    });
+    starts_.reserve(intervals.size());
+    ends_.reserve(intervals.size());
+    trip_ids_.reserve(intervals.size());
+    trip_starts_.reserve(intervals.size());
+    for (const auto& interval : intervals) {
+        if (!trip_starts_.emplace(interval.trip_id, interval.start).second) continue;
+        starts_.push_back(interval.start);
+        ends_.push_back(interval.end);
+        trip_ids_.push_back(interval.trip_id);
+        max_duration_ = std::max(max_duration_, interval.end - interval.start);
+    }
+}
+
+void TripIntervalIndex::insert(int trip_id, int start, int end) {
+    remove(trip_id);
+    // Posición tras las salidas menores y, a igual salida, los ids menores
+    size_t position = std::lower_bound(starts_.begin(), starts_.end(), start) - starts_.begin();
+    while (position < starts_.size() && starts_[position] == start && trip_ids_[position] < trip_id) ++position;
+    starts_.insert(starts_.begin() + position, start);
+    ends_.insert(ends_.begin() + position, end);
+    trip_ids_.insert(trip_ids_.begin() + position, trip_id);
+    trip_starts_[trip_id] = start;
+    max_duration_ = std::max(max_duration_, end - start);
+}
+
+bool TripIntervalIndex::remove(int trip_id) {
+    size_t position = position_of(trip_id);
+    if (position == trip_ids_.size()) return false;
+    starts_.erase(starts_.begin() + position);
+    ends_.erase(ends_.begin() + position);
+    trip_ids_.erase(trip_ids_.begin() + position);
+    trip_starts_.erase(trip_id);
+    return true;
+}
+
+std::vector<int> TripIntervalIndex::within(int from, int until) const {
+    std::vector<int> result;
+    if (from > until) return result;
+    size_t begin = std::lower_bound(starts_.begin(), starts_.end(), from) - starts_.begin();
+    size_t end = std::upper_bound(starts_.begin(), starts_.end(), until) - starts_.begin();
+    for (size_t i = begin; i < end; ++i) {
+        if (ends_[i] <= until) result.push_back(trip_ids_[i]);
+    }
+    return result;
+}
+
+std::vector<int> TripIntervalIndex::overlapping(int from, int until) const {
+    std::vector<int> result;
+    if (from > until) return result;
+    // Ninguna salida anterior a from - max_duration_ llega hasta from
+    size_t begin = std::lower_bound(starts_.begin(), starts_.end(), from - max_duration_) - starts_.begin();
+    size_t end = std::upper_bound(starts_.begin(), starts_.end(), until) - starts_.begin();
+    for (size_t i = begin; i < end; ++i) {
+        if (ends_[i] >= from) result.push_back(trip_ids_[i]);
+    }
+    return result;
+}
+
+std::vector<int> TripIntervalIndex::active_between(int from, int until) const {
+    std::vector<int> result = overlapping(from, until);
+    if (from >= SECONDS_PER_DAY) return result;
+
+    // Mismo instante expresado en el día de servicio anterior; esos viajes
+    // salieron antes y van delante
+    std::vector<int> previous_day = overlapping(from + SECONDS_PER_DAY, until + SECONDS_PER_DAY);
+    if (previous_day.empty()) return result;
+    // Un viaje largo puede casar en los dos días: se queda en el actual
+    std::unordered_set<int> today(result.begin(), result.end());
+    std::vector<int> merged;
+    merged.reserve(previous_day.size() + result.size());
+    for (int trip_id : previous_day) {
+        if (today.count(trip_id) == 0) merged.push_back(trip_id);
+    }
+    merged.insert(merged.end(), result.begin(), result.end());
+    return merged;
+}
+
+size_t TripIntervalIndex::position_of(int trip_id) const {
+    auto it = trip_starts_.find(trip_id);
+    if (it == trip_starts_.end()) return trip_ids_.size();
+    size_t position = std::lower_bound(starts_.begin(), starts_.end(), it->second) - starts_.begin();
+    while (position < trip_ids_.size() && trip_ids_[position] != trip_id) ++position;
+    return position;
+}
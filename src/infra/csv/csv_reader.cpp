@@ -0,0 +1,221 @@
+#include "infra/csv_reader.h"
+#include <algorithm>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define URBAN_TRANSPORT_POSIX_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace urban_transport;
+
+namespace {
+
+// Bloque de páginas leídas que se devuelve al sistema de una vez
+constexpr size_t RELEASE_CHUNK = 16 * 1024 * 1024;
+// Ventana de lectura sin mmap; crece solo si un registro no cabe
+constexpr size_t READ_WINDOW = 4 * 1024 * 1024;
+
+} // namespace
+
+CsvReader::~CsvReader() {
+    close();
+}
+
+bool CsvReader::open(const std::string& path) {
+    close();
+#ifdef URBAN_TRANSPORT_POSIX_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+    }
+    size_ = static_cast<size_t>(info.st_size);
+    if (size_ == 0) {
+        // mmap no admite longitud 0: fichero vacío, sin cabecera
+        ::close(fd);
+        opened_empty_ = true;
+        return true;
+    }
+
+    void* address = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        size_ = 0;
+        return false;
+    }
+    madvise(address, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const char*>(address);
+    limit_ = size_;
+    mapped_ = true;
+#else
+    file_.open(path, std::ios::binary | std::ios::ate);
+    if (!file_) return false;
+    size_ = static_cast<size_t>(std::max<std::streamoff>(file_.tellg(), 0));
+    file_.seekg(0);
+    if (size_ == 0) {
+        file_.close();
+        opened_empty_ = true;
+        return true;
+    }
+    buffer_.resize(READ_WINDOW);
+    data_ = buffer_.data();
+    refill();
+#endif
+
+    if (limit_ >= 3 && data_[0] == '\xEF' && data_[1] == '\xBB' && data_[2] == '\xBF') position_ = 3;
+
+    std::vector<std::string_view> fields;
+    if (next(fields)) {
+        for (auto field : fields) {
+            while (!field.empty() && field.front() == ' ') field.remove_prefix(1);
+            while (!field.empty() && field.back() == ' ') field.remove_suffix(1);
+            header_.emplace_back(field);
+        }
+    }
+    return true;
+}
+
+void CsvReader::close() {
+#ifdef URBAN_TRANSPORT_POSIX_MMAP
+    if (mapped_) munmap(const_cast<char*>(data_), size_);
+#endif
+    if (file_.is_open()) file_.close();
+    buffer_.clear();
+    buffer_.shrink_to_fit();
+    mapped_ = false;
+    data_ = nullptr;
+    size_ = 0;
+    limit_ = 0;
+    base_ = 0;
+    position_ = 0;
+    released_ = 0;
+    opened_empty_ = false;
+    header_.clear();
+}
+
+int CsvReader::column(std::string_view name) const {
+    for (size_t i = 0; i < header_.size(); ++i) {
+        if (header_[i] == name) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+bool CsvReader::next(std::vector<std::string_view>& fields) {
+    if (!data_) return false;
+
+    while (true) {
+        fields.clear();
+        scratch_.clear();
+        unescaped_.clear();
+        while (position_ < limit_ && (data_[position_] == '\n' || data_[position_] == '\r')) ++position_;
+        if (position_ >= limit_) {
+            if (refill()) continue;
+            return false;
+        }
+
+        // Un registro que llega al final de la ventana puede seguir en el
+        // fichero: se vuelve a leer entero tras rellenarla
+        size_t start = position_;
+        parse_record(fields);
+        if (position_ < limit_ || !more_input()) break;
+        position_ = start;
+        refill();
+    }
+
+    // scratch_ ya no crece: las vistas sobre él son estables hasta next()
+    for (const auto& field : unescaped_) {
+        fields[field.field] = std::string_view(scratch_.data() + field.offset, field.length);
+    }
+    if (mapped_ && position_ - released_ >= RELEASE_CHUNK) release_consumed();
+    return true;
+}
+
+void CsvReader::parse_record(std::vector<std::string_view>& fields) {
+    while (true) {
+        if (position_ < limit_ && data_[position_] == '"') {
+            size_t start = ++position_;
+            bool escaped = false;
+            while (position_ < limit_) {
+                if (data_[position_] == '"') {
+                    if (position_ + 1 < limit_ && data_[position_ + 1] == '"') {
+                        escaped = true;
+                        position_ += 2;
+                        continue;
+                    }
+                    break;
+                }
+                ++position_;
+            }
+            size_t end = position_;
+            if (position_ < limit_) ++position_; // comilla de cierre
+
+            if (escaped) {
+                size_t offset = scratch_.size();
+                for (size_t i = start; i < end; ++i) {
+                    scratch_.push_back(data_[i]);
+                    if (data_[i] == '"') ++i; // "" -> "
+                }
+                unescaped_.push_back({fields.size(), offset, scratch_.size() - offset});
+                fields.emplace_back();
+            } else {
+                fields.emplace_back(data_ + start, end - start);
+            }
+            // Lo que haya entre la comilla de cierre y el separador se ignora
+            while (position_ < limit_ && data_[position_] != ',' && data_[position_] != '\n' &&
+                   data_[position_] != '\r') {
+                ++position_;
+            }
+        } else {
+            size_t start = position_;
+            while (position_ < limit_ && data_[position_] != ',' && data_[position_] != '\n' &&
+                   data_[position_] != '\r') {
+                ++position_;
+            }
+            fields.emplace_back(data_ + start, position_ - start);
+        }
+
+        if (position_ < limit_ && data_[position_] == ',') {
+            ++position_;
+            continue;
+        }
+        if (position_ < limit_ && data_[position_] == '\r') ++position_;
+        if (position_ < limit_ && data_[position_] == '\n') ++position_;
+        break;
+    }
+}
+
+bool CsvReader::refill() {
+    if (!more_input()) return false;
+    // Lo pendiente pasa al principio; la ventana crece si está llena
+    size_t pending = limit_ - position_;
+    std::copy(buffer_.begin() + position_, buffer_.begin() + limit_, buffer_.begin());
+    base_ += position_;
+    position_ = 0;
+    limit_ = pending;
+    if (limit_ == buffer_.size()) buffer_.resize(buffer_.size() * 2);
+    data_ = buffer_.data();
+
+    file_.read(buffer_.data() + limit_, static_cast<std::streamsize>(buffer_.size() - limit_));
+    size_t read = static_cast<size_t>(file_.gcount());
+    limit_ += read;
+    return read > 0;
+}
+
+#ifdef URBAN_TRANSPORT_POSIX_MMAP
+void CsvReader::release_consumed() {
+    long page = sysconf(_SC_PAGESIZE);
+    size_t page_size = page > 0 ? static_cast<size_t>(page) : 4096;
+    size_t end = position_ / page_size * page_size;
+    if (end <= released_) return;
+    madvise(const_cast<char*>(data_) + released_, end - released_, MADV_DONTNEED);
+    released_ = end;
+}
+#else
+void CsvReader::release_consumed() {}
+#endif
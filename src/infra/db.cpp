@@ -20,44 +20,66 @@ public:
     }
     
     bool execute(const std::string& sql) {
-        Logger::get_instance().debug("Ejecutando SQL: " + sql);
+        trace("Ejecutando SQL: ", sql);
         return sqlite_.execute(sql);
     }
     
     bool execute_with_params(const std::string& sql, const std::vector<std::string>& params) {
-        Logger::get_instance().debug("Ejecutando SQL con parámetros: " + sql);
+        trace("Ejecutando SQL con parámetros: ", sql);
         return sqlite_.execute_with_params(sql, params);
     }
     
     bool query(const std::string& sql, RowCallback callback) const {
-        Logger::get_instance().debug("Consultando SQL: " + sql);
+        trace("Consultando SQL: ", sql);
         return sqlite_.query(sql, callback);
     }
     
     bool query_with_params(const std::string& sql, 
                           const std::vector<std::string>& params,
                           RowCallback callback) const {
-        Logger::get_instance().debug("Consultando SQL con parámetros: " + sql);
+        trace("Consultando SQL con parámetros: ", sql);
         return sqlite_.query_with_params(sql, params, callback);
     }
     
+    bool execute_with_values(const std::string& sql, const std::vector<SqlParam>& params) {
+        trace("Ejecutando SQL con parámetros: ", sql);
+        return sqlite_.execute_with_values(sql, params);
+    }
+
+    bool query_rows(const std::string& sql, const std::vector<SqlParam>& params,
+                    RowViewCallback callback) const {
+        trace("Consultando SQL: ", sql);
+        return sqlite_.query_rows(sql, params, callback);
+    }
+
     bool begin_transaction() {
-        Logger::get_instance().debug("Iniciando transacción");
+        trace("Iniciando transacción");
         return sqlite_.begin_transaction();
     }
     
     bool commit_transaction() {
-        Logger::get_instance().debug("Confirmando transacción");
+        trace("Confirmando transacción");
         return sqlite_.commit_transaction();
     }
     
     bool rollback_transaction() {
-        Logger::get_instance().debug("Revirtiendo transacción");
+        trace("Revirtiendo transacción");
         return sqlite_.rollback_transaction();
     }
 
+    void set_statement_logging(bool enabled) {
+        log_statements_ = enabled;
+    }
+
 private:
     SQLiteWrapper sqlite_;
+    bool log_statements_ = true;
+
+    // El mensaje solo se construye si el registro está activo
+    void trace(const char* message, const std::string& sql = std::string()) const {
+        if (!log_statements_) return;
+        Logger::get_instance().debug(message + sql);
+    }
 };
 
 // Implementación de Database
@@ -94,6 +116,19 @@ bool Database::query_with_params(const std::string& sql,
     return pimpl->query_with_params(sql, params, callback);
 }
 
+bool Database::execute_with_values(const std::string& sql, const std::vector<SqlParam>& params) {
+    return pimpl->execute_with_values(sql, params);
+}
+
+bool Database::query_rows(const std::string& sql, RowViewCallback callback) const {
+    return pimpl->query_rows(sql, {}, callback);
+}
+
+bool Database::query_rows(const std::string& sql, const std::vector<SqlParam>& params,
+                          RowViewCallback callback) const {
+    return pimpl->query_rows(sql, params, callback);
+}
+
 bool Database::begin_transaction() {
     return pimpl->begin_transaction();
 }
@@ -104,4 +139,15 @@ bool Database::commit_transaction() {
 
 bool Database::rollback_transaction() {
     return pimpl->rollback_transaction();
+}
+
+void Database::set_statement_logging(bool enabled) {
+    pimpl->set_statement_logging(enabled);
+}
+
+bool Database::run_in_transaction(const std::function<bool()>& body) {
+    if (!pimpl->begin_transaction()) return false;
+    if (body() && pimpl->commit_transaction()) return true;
+    pimpl->rollback_transaction();
+    return false;
 }
\ No newline at end of file
@@ -13,20 +13,23 @@ Logger& Logger::get_instance() {
 }
 
 void Logger::initialize(const std::string& filename) {
-    std::lock_guard<std::mutex> lock(log_mutex_);
-    if (initialized_) return;
-    if (!filename.empty()) {
-        log_file_.open(filename, std::ios::app);
-        if (log_file_.is_open()) use_file_ = true;
+    {
+        std::lock_guard<std::mutex> lock(log_mutex_);
+        if (initialized_) return;
+        if (!filename.empty()) {
+            log_file_.open(filename, std::ios::app);
+            if (log_file_.is_open()) use_file_ = true;
+        }
+        initialized_ = true;
     }
-    initialized_ = true;
+    // log() toma el mutex, por eso se llama fuera de la sección crítica
     log(LogLevel::INFO, "Logger initialized");
 }
 
 void Logger::shutdown() {
-    std::lock_guard<std::mutex> lock(log_mutex_);
     if (!initialized_) return;
     log(LogLevel::INFO, "Logger shutdown");
+    std::lock_guard<std::mutex> lock(log_mutex_);
     if (log_file_.is_open()) log_file_.close();
     initialized_ = false;
     use_file_ = false;
@@ -0,0 +1,31 @@
+#include "infra/row_view.h"
+#include <sqlite3.h>
+
+using namespace urban_transport;
+
+int RowView::column_count() const {
+    return sqlite3_column_count(stmt_);
+}
+
+bool RowView::is_null(int column) const {
+    return sqlite3_column_type(stmt_, column) == SQLITE_NULL;
+}
+
+int RowView::get_int(int column) const {
+    return sqlite3_column_int(stmt_, column);
+}
+
+int64_t RowView::get_int64(int column) const {
+    return sqlite3_column_int64(stmt_, column);
+}
+
+double RowView::get_double(int column) const {
+    return sqlite3_column_double(stmt_, column);
+}
+
+std::string_view RowView::get_text(int column) const {
+    // column_text antes que column_bytes, como pide la documentación de SQLite
+    const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt_, column));
+    if (!text) return {};
+    return std::string_view(text, static_cast<size_t>(sqlite3_column_bytes(stmt_, column)));
+}
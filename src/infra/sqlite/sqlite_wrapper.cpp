@@ -65,9 +65,8 @@ bool SQLiteWrapper::execute_with_params(const std::string& sql, const std::vecto
         return false;
     }
     
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
+    sqlite3_stmt* stmt = acquire_statement(sql);
+    if (!stmt) {
         Logger::get_instance().error("Error al preparar statement: " + safe_sqlite_errmsg(db_));
         return false;
     }
@@ -77,14 +76,14 @@ bool SQLiteWrapper::execute_with_params(const std::string& sql, const std::vecto
         sqlite3_bind_text(stmt, i + 1, params[i].c_str(), -1, SQLITE_TRANSIENT);
     }
     
-    rc = sqlite3_step(stmt);
+    int rc = sqlite3_step(stmt);
     bool success = (rc == SQLITE_DONE);
     
     if (!success) {
         Logger::get_instance().error("Error en execute_with_params: " + safe_sqlite_errmsg(db_));
     }
     
-    sqlite3_finalize(stmt);
+    release_statement(sql, stmt);
     return success;
 }
 
@@ -94,17 +93,18 @@ bool SQLiteWrapper::query(const std::string& sql, RowCallback callback) const {
         return false;
     }
     
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
+    sqlite3_stmt* stmt = acquire_statement(sql);
+    if (!stmt) {
         Logger::get_instance().error("Error al preparar query: " + safe_sqlite_errmsg(db_));
         return false;
     }
+    int rc;
     
     bool success = true;
     while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
         int column_count = sqlite3_column_count(stmt);
         std::vector<std::string> row;
+        row.reserve(column_count);
         
         for (int i = 0; i < column_count; ++i) {
             const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, i));
@@ -121,7 +121,7 @@ bool SQLiteWrapper::query(const std::string& sql, RowCallback callback) const {
         success = false;
     }
     
-    sqlite3_finalize(stmt);
+    release_statement(sql, stmt);
     return success;
 }
 
@@ -133,12 +133,12 @@ bool SQLiteWrapper::query_with_params(const std::string& sql,
         return false;
     }
     
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr);
-    if (rc != SQLITE_OK) {
+    sqlite3_stmt* stmt = acquire_statement(sql);
+    if (!stmt) {
         Logger::get_instance().error("Error al preparar query con parámetros: " + safe_sqlite_errmsg(db_));
         return false;
     }
+    int rc;
     
     // Vincular parámetros
     for (size_t i = 0; i < params.size(); ++i) {
@@ -149,6 +149,7 @@ bool SQLiteWrapper::query_with_params(const std::string& sql,
     while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
         int column_count = sqlite3_column_count(stmt);
         std::vector<std::string> row;
+        row.reserve(column_count);
         
         for (int i = 0; i < column_count; ++i) {
             const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, i));
@@ -165,7 +166,82 @@ bool SQLiteWrapper::query_with_params(const std::string& sql,
         success = false;
     }
     
-    sqlite3_finalize(stmt);
+    release_statement(sql, stmt);
+    return success;
+}
+
+void SQLiteWrapper::bind_values(sqlite3_stmt* stmt, const std::vector<SqlParam>& params) {
+    for (size_t i = 0; i < params.size(); ++i) {
+        int index = static_cast<int>(i) + 1;
+        const auto& value = params[i].value();
+        if (const auto* integer = std::get_if<int64_t>(&value)) {
+            sqlite3_bind_int64(stmt, index, *integer);
+        } else if (const auto* real = std::get_if<double>(&value)) {
+            sqlite3_bind_double(stmt, index, *real);
+        } else if (const auto* text = std::get_if<std::string_view>(&value)) {
+            // Sin copia: la sentencia se reinicia antes de volver al llamador
+            // Un string_view vacío puede no tener puntero: se vincula "" y no NULL
+            sqlite3_bind_text(stmt, index, text->data() ? text->data() : "",
+                              static_cast<int>(text->size()), SQLITE_STATIC);
+        } else {
+            sqlite3_bind_null(stmt, index);
+        }
+    }
+}
+
+bool SQLiteWrapper::execute_with_values(const std::string& sql, const std::vector<SqlParam>& params) {
+    if (!db_) {
+        Logger::get_instance().error("Base de datos no está abierta");
+        return false;
+    }
+
+    sqlite3_stmt* stmt = acquire_statement(sql);
+    if (!stmt) {
+        Logger::get_instance().error("Error al preparar statement: " + safe_sqlite_errmsg(db_));
+        return false;
+    }
+
+    bind_values(stmt, params);
+    bool success = sqlite3_step(stmt) == SQLITE_DONE;
+    if (!success) {
+        Logger::get_instance().error("Error en execute_with_values: " + safe_sqlite_errmsg(db_));
+    }
+
+    release_statement(sql, stmt);
+    return success;
+}
+
+bool SQLiteWrapper::query_rows(const std::string& sql, RowViewCallback callback) const {
+    return query_rows(sql, {}, std::move(callback));
+}
+
+bool SQLiteWrapper::query_rows(const std::string& sql, const std::vector<SqlParam>& params,
+                               RowViewCallback callback) const {
+    if (!db_) {
+        Logger::get_instance().error("Base de datos no está abierta");
+        return false;
+    }
+
+    sqlite3_stmt* stmt = acquire_statement(sql);
+    if (!stmt) {
+        Logger::get_instance().error("Error al preparar query: " + safe_sqlite_errmsg(db_));
+        return false;
+    }
+
+    bind_values(stmt, params);
+    RowView row(stmt);
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        if (!callback(row)) break;
+    }
+
+    bool success = true;
+    if (rc != SQLITE_DONE && rc != SQLITE_ROW) {
+        Logger::get_instance().error("Error durante query: " + safe_sqlite_errmsg(db_));
+        success = false;
+    }
+
+    release_statement(sql, stmt);
     return success;
 }
 
@@ -189,7 +265,74 @@ int SQLiteWrapper::last_error_code() const {
     return db_ ? sqlite3_errcode(db_) : -1;
 }
 
+void SQLiteWrapper::set_statement_cache_capacity(size_t capacity) {
+    std::lock_guard<std::mutex> lock(statement_cache_mutex_);
+    statement_cache_capacity_ = capacity;
+    evict_statements(capacity);
+}
+
+StatementCacheStats SQLiteWrapper::statement_cache_stats() const {
+    std::lock_guard<std::mutex> lock(statement_cache_mutex_);
+    StatementCacheStats stats;
+    stats.hits = statement_cache_hits_;
+    stats.misses = statement_cache_misses_;
+    stats.size = statement_cache_.size();
+    stats.capacity = statement_cache_capacity_;
+    return stats;
+}
+
+sqlite3_stmt* SQLiteWrapper::acquire_statement(const std::string& sql) const {
+    {
+        std::lock_guard<std::mutex> lock(statement_cache_mutex_);
+        auto it = statement_cache_.find(sql);
+        if (it != statement_cache_.end()) {
+            sqlite3_stmt* stmt = it->second.stmt;
+            statement_lru_.erase(it->second.position);
+            statement_cache_.erase(it);
+            ++statement_cache_hits_;
+            return stmt;
+        }
+        ++statement_cache_misses_;
+    }
+
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        sqlite3_finalize(stmt);
+        return nullptr;
+    }
+    return stmt;
+}
+
+void SQLiteWrapper::release_statement(const std::string& sql, sqlite3_stmt* stmt) const {
+    // reset cierra la lectura en curso; los errores ya se trataron en step
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    std::lock_guard<std::mutex> lock(statement_cache_mutex_);
+    if (statement_cache_capacity_ == 0 || statement_cache_.count(sql) > 0) {
+        sqlite3_finalize(stmt);
+        return;
+    }
+
+    statement_lru_.push_front(sql);
+    statement_cache_.emplace(sql, CachedStatement{stmt, statement_lru_.begin()});
+    evict_statements(statement_cache_capacity_);
+}
+
+void SQLiteWrapper::evict_statements(size_t capacity) const {
+    while (statement_cache_.size() > capacity) {
+        auto oldest = statement_cache_.find(statement_lru_.back());
+        sqlite3_finalize(oldest->second.stmt);
+        statement_cache_.erase(oldest);
+        statement_lru_.pop_back();
+    }
+}
+
 void SQLiteWrapper::cleanup() {
+    // sqlite3_close falla mientras queden sentencias sin finalizar
+    {
+        std::lock_guard<std::mutex> lock(statement_cache_mutex_);
+        evict_statements(0);
+    }
     if (db_) {
         sqlite3_close(db_);
         db_ = nullptr;
@@ -91,7 +91,7 @@ int main()
 
     TransportSystem system;
 
-    if (!system.initialize("data/transport.db")) {
+    if (!system.initialize("data/transport.db", "data/transport.snapshot")) {
         std::cerr << "Error al inicializar el sistema de transporte\n";
         return 1;
     }
@@ -1,8 +1,16 @@
 #include <gtest/gtest.h>
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cmath>
+#include <thread>
 #include <unordered_map>
 #include "core/algorithms.h"
 #include "core/graph.h"
+#include "core/contraction_hierarchy.h"
+#include "core/stop_route_index.h"
+#include "core/spatial_index.h"
+#include "core/geo_distance.h"
 
 using namespace urban_transport;
 
@@ -62,4 +70,399 @@ TEST_F(AlgorithmsTest, FindRoutesThroughStop) {
     EXPECT_EQ(routes.size(), 2);
     EXPECT_TRUE(std::find(routes.begin(), routes.end(), 1) != routes.end());
     EXPECT_TRUE(std::find(routes.begin(), routes.end(), 2) != routes.end());
-}
\ No newline at end of file
+
+    StopRouteIndex index(route_stops);
+    EXPECT_EQ(TransportAlgorithms::find_routes_through_stop(index, 102), (std::vector<int>{1, 2}));
+    EXPECT_TRUE(TransportAlgorithms::find_routes_through_stop(index, 999).empty());
+}
+
+TEST_F(AlgorithmsTest, StopRouteIndexAnswersDirectRoutes) {
+    std::unordered_map<int, std::vector<int>> route_stops = {
+        {1, {101, 102, 103}},
+        {2, {103, 102, 104, 105}},
+        {3, {106, 107, 108}},
+        {4, {109, 102, 110, 102}} // circular: pasa dos veces por 102
+    };
+    StopRouteIndex index(route_stops);
+
+    EXPECT_EQ(index.routes_through(102), (std::vector<int>{1, 2, 4}));
+    EXPECT_TRUE(index.routes_through(999).empty());
+    EXPECT_EQ(index.route_stops(2), (std::vector<int>{103, 102, 104, 105}));
+
+    EXPECT_EQ(index.direct_routes(102, 103), (std::vector<int>{1}));
+    EXPECT_EQ(index.direct_routes(103, 102), (std::vector<int>{2}));
+    EXPECT_EQ(index.direct_routes(110, 102), (std::vector<int>{4}));
+    EXPECT_TRUE(index.direct_routes(105, 102).empty());
+    EXPECT_TRUE(index.direct_routes(101, 108).empty());
+}
+
+TEST_F(AlgorithmsTest, CsrGraphMapsStopIds) {
+    CsrGraph csr(graph);
+    ASSERT_EQ(csr.node_count(), 4);
+    EXPECT_EQ(csr.edge_count(), 4);
+    EXPECT_EQ(csr.index_of(99), -1);
+
+    int index = csr.index_of(1);
+    ASSERT_GE(index, 0);
+    EXPECT_EQ(csr.node_id(index), 1);
+    EXPECT_EQ(csr.edge_end(index) - csr.edge_begin(index), 2u);
+}
+
+TEST_F(AlgorithmsTest, CsrDijkstraMatchesGraph) {
+    CsrGraph csr(graph);
+    EXPECT_EQ(TransportAlgorithms::dijkstra_shortest_path(csr, 1, 4),
+              TransportAlgorithms::dijkstra_shortest_path(graph, 1, 4));
+    EXPECT_EQ(TransportAlgorithms::dijkstra_shortest_path(csr, 2, 2), std::vector<int>{2});
+    EXPECT_TRUE(TransportAlgorithms::dijkstra_shortest_path(csr, 4, 1).empty());
+}
+
+TEST_F(AlgorithmsTest, SearchWorkspaceReusedAcrossQueries) {
+    CsrGraph csr(graph);
+    SearchWorkspace workspace;
+
+    auto first = TransportAlgorithms::dijkstra_shortest_path(csr, 1, 4, workspace);
+    auto second = TransportAlgorithms::dijkstra_shortest_path(csr, 2, 4, workspace);
+    auto third = TransportAlgorithms::dijkstra_shortest_path(csr, 1, 4, workspace);
+
+    EXPECT_EQ(first, (std::vector<int>{1, 2, 3, 4}));
+    EXPECT_EQ(second, (std::vector<int>{2, 3, 4}));
+    EXPECT_EQ(third, first);
+
+    // Tras una búsqueda nueva no quedan distancias de la anterior
+    workspace.reset(csr.node_count());
+    EXPECT_FALSE(workspace.reached(csr.index_of(1)));
+}
+
+// Malla 6x6 de paradas con pesos Haversine y algunas aristas retiradas
+class GeoRoutingTest : public ::testing::Test {
+protected:
+    static constexpr int side = 6;
+
+    void SetUp() override {
+        for (int r = 0; r < side; ++r) {
+            for (int c = 0; c < side; ++c) {
+                grid.set_coordinates(id(r, c), -13.52 + r * 0.004, -71.97 + c * 0.005);
+            }
+        }
+        for (int r = 0; r < side; ++r) {
+            for (int c = 0; c < side; ++c) {
+                if ((r * 7 + c * 3) % 5 == 0) continue;
+                if (c + 1 < side) connect(id(r, c), id(r, c + 1));
+                if (r + 1 < side) connect(id(r, c), id(r + 1, c));
+            }
+        }
+    }
+
+    static int id(int r, int c) { return r * side + c + 1; }
+
+    void connect(int a, int b) {
+        double lat1, lon1, lat2, lon2;
+        grid.get_coordinates(a, lat1, lon1);
+        grid.get_coordinates(b, lat2, lon2);
+        double d = TransportAlgorithms::calculate_distance(lat1, lon1, lat2, lon2);
+        grid.add_edge(a, b, d);
+        grid.add_edge(b, a, d);
+    }
+
+    double path_cost(const std::vector<int>& path) const {
+        double total = 0.0;
+        for (size_t i = 0; i + 1 < path.size(); ++i) {
+            for (const auto& edge : grid.get_edges(path[i])) {
+                if (edge.target == path[i + 1]) { total += edge.weight; break; }
+            }
+        }
+        return total;
+    }
+
+    Graph grid;
+};
+
+TEST_F(GeoRoutingTest, AStarMatchesDijkstra) {
+    CsrGraph csr(grid);
+    for (int from : {1, 8, 15}) {
+        for (int to : {36, 30, 6}) {
+            auto expected = TransportAlgorithms::dijkstra_shortest_path(csr, from, to);
+            auto actual = TransportAlgorithms::astar_shortest_path(csr, from, to);
+            ASSERT_EQ(actual.empty(), expected.empty());
+            EXPECT_NEAR(path_cost(actual), path_cost(expected), 1e-9);
+        }
+    }
+}
+
+TEST_F(GeoRoutingTest, BidirectionalMatchesDijkstra) {
+    CsrGraph csr(grid);
+    for (int from : {1, 8, 15, 36}) {
+        for (int to : {36, 30, 6, 1}) {
+            auto expected = TransportAlgorithms::dijkstra_shortest_path(csr, from, to);
+            auto actual = TransportAlgorithms::bidirectional_dijkstra(csr, from, to);
+            ASSERT_EQ(actual.empty(), expected.empty());
+            if (expected.empty()) continue;
+            EXPECT_EQ(actual.front(), from);
+            EXPECT_EQ(actual.back(), to);
+            EXPECT_NEAR(path_cost(actual), path_cost(expected), 1e-9);
+        }
+    }
+}
+
+TEST_F(AlgorithmsTest, ReverseAdjacencyFollowsRemoveEdge) {
+    ASSERT_EQ(graph.get_incoming_edges(4).size(), 2u);
+    graph.remove_edge(1, 4);
+    ASSERT_EQ(graph.get_incoming_edges(4).size(), 1u);
+    EXPECT_EQ(graph.get_incoming_edges(4)[0].target, 3);
+
+    CsrGraph csr(graph);
+    int index = csr.index_of(4);
+    ASSERT_EQ(csr.in_edge_end(index) - csr.in_edge_begin(index), 1u);
+    EXPECT_EQ(csr.node_id(csr.in_edge_source(csr.in_edge_begin(index))), 3);
+    EXPECT_EQ(TransportAlgorithms::bidirectional_dijkstra(csr, 1, 4),
+              (std::vector<int>{1, 2, 3, 4}));
+}
+
+TEST_F(GeoRoutingTest, ContractionHierarchyMatchesDijkstra) {
+    CsrGraph csr(grid);
+    ContractionHierarchy hierarchy(csr, 2);
+    ASSERT_EQ(hierarchy.node_count(), csr.node_count());
+
+    for (int from = 1; from <= side * side; from += 5) {
+        for (int to = 1; to <= side * side; to += 7) {
+            auto expected = TransportAlgorithms::dijkstra_shortest_path(csr, from, to);
+            auto actual = hierarchy.shortest_path(from, to);
+            ASSERT_EQ(actual.empty(), expected.empty());
+            if (expected.empty()) continue;
+            EXPECT_EQ(actual.front(), from);
+            EXPECT_EQ(actual.back(), to);
+            EXPECT_NEAR(path_cost(actual), path_cost(expected), 1e-9);
+        }
+    }
+}
+
+TEST_F(GeoRoutingTest, ContractionHierarchyRoundTripsThroughFile) {
+    CsrGraph csr(grid);
+    ContractionHierarchy hierarchy(csr);
+    const std::string filename = "test_hierarchy.ch";
+    ASSERT_TRUE(hierarchy.save(filename));
+
+    ContractionHierarchy loaded;
+    ASSERT_TRUE(loaded.load(filename));
+    std::remove(filename.c_str());
+
+    EXPECT_EQ(loaded.arc_count(), hierarchy.arc_count());
+    EXPECT_EQ(loaded.shortest_path(1, 36), hierarchy.shortest_path(1, 36));
+    EXPECT_FALSE(loaded.load("missing_hierarchy.ch"));
+}
+
+TEST_F(GeoRoutingTest, LandmarksGiveAdmissibleBounds) {
+    CsrGraph csr(grid);
+    for (auto selection : {LandmarkSelection::FARTHEST, LandmarkSelection::AVOID}) {
+        LandmarkIndex landmarks(csr, 4, selection, 2);
+        ASSERT_EQ(landmarks.landmark_count(), 4u);
+
+        for (int from : {1, 8, 15, 36}) {
+            for (int to : {36, 30, 6, 1}) {
+                auto expected = TransportAlgorithms::dijkstra_shortest_path(csr, from, to);
+                auto actual = TransportAlgorithms::alt_shortest_path(csr, landmarks, from, to);
+                ASSERT_EQ(actual.empty(), expected.empty());
+                if (expected.empty()) continue;
+                EXPECT_NEAR(path_cost(actual), path_cost(expected), 1e-9);
+                EXPECT_LE(landmarks.lower_bound(csr.index_of(from), csr.index_of(to)),
+                          path_cost(expected) + 1e-9);
+            }
+        }
+    }
+}
+
+TEST_F(GeoRoutingTest, LandmarksSurviveWeightIncrease) {
+    CsrGraph before(grid);
+    LandmarkIndex landmarks(before, 3);
+
+    // Un retraso encarece el primer tramo del camino óptimo
+    auto original = TransportAlgorithms::dijkstra_shortest_path(before, 8, 36);
+    ASSERT_GE(original.size(), 2u);
+    ASSERT_TRUE(grid.set_edge_weight(original[0], original[1], 10.0));
+    CsrGraph after(grid);
+
+    auto expected = TransportAlgorithms::dijkstra_shortest_path(after, 8, 36);
+    auto actual = TransportAlgorithms::alt_shortest_path(after, landmarks, 8, 36);
+    EXPECT_NEAR(path_cost(actual), path_cost(expected), 1e-9);
+    EXPECT_NE(actual, original);
+}
+
+TEST_F(GeoRoutingTest, DistanceMatrixMatchesSingleQueries) {
+    CsrGraph csr(grid);
+    ThreadPool pool(3);
+    std::vector<int> sources = {1, 8, 15, 22, 999};
+    std::vector<int> targets = {36, 6, 8, 8};
+
+    auto matrix = TransportAlgorithms::distance_matrix(csr, sources, targets, pool);
+    ASSERT_EQ(matrix.size(), sources.size() * targets.size());
+
+    for (size_t i = 0; i < sources.size(); ++i) {
+        for (size_t j = 0; j < targets.size(); ++j) {
+            auto path = TransportAlgorithms::dijkstra_shortest_path(csr, sources[i], targets[j]);
+            double value = matrix[i * targets.size() + j];
+            if (path.empty()) {
+                EXPECT_TRUE(std::isinf(value));
+            } else {
+                EXPECT_NEAR(value, path_cost(path), 1e-9);
+            }
+        }
+    }
+}
+
+TEST_F(AlgorithmsTest, ThreadPoolRunsEveryIndexOnce) {
+    ThreadPool pool(4);
+    std::vector<int> hits(1000, 0);
+    std::vector<size_t> workers(hits.size());
+
+    // Coste desigual: los primeros índices tardan más y fuerzan el robo de trabajo
+    pool.parallel_for(hits.size(), [&](size_t i, size_t worker) {
+        if (i < 10) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        ++hits[i];
+        workers[i] = worker;
+    });
+
+    for (size_t i = 0; i < hits.size(); ++i) {
+        EXPECT_EQ(hits[i], 1);
+        EXPECT_LT(workers[i], pool.size());
+    }
+
+    // El pool se reutiliza entre lotes, también con lotes vacíos
+    pool.parallel_for(0, [&](size_t i, size_t) { ++hits[i]; });
+    pool.parallel_for(3, [&](size_t i, size_t) { ++hits[i]; });
+    EXPECT_EQ(hits[0], 2);
+    EXPECT_EQ(hits[3], 1);
+}
+
+TEST_F(GeoRoutingTest, IsochroneMatchesDijkstraWithinBudget) {
+    CsrGraph csr(grid);
+    double budget = 2.0;
+    auto reached = TransportAlgorithms::isochrone(csr, 8, budget);
+
+    ASSERT_FALSE(reached.empty());
+    EXPECT_EQ(reached.front().stop_id, 8);
+    EXPECT_DOUBLE_EQ(reached.front().cost, 0.0);
+    for (size_t i = 1; i < reached.size(); ++i) EXPECT_LE(reached[i - 1].cost, reached[i].cost);
+
+    std::unordered_map<int, double> cost;
+    for (const auto& stop : reached) cost[stop.stop_id] = stop.cost;
+    for (int node = 2; node <= 36; ++node) {
+        double exact = path_cost(TransportAlgorithms::dijkstra_shortest_path(csr, 8, node));
+        if (exact <= budget) {
+            ASSERT_TRUE(cost.count(node)) << node;
+            EXPECT_NEAR(cost[node], exact, 1e-9);
+        } else {
+            EXPECT_FALSE(cost.count(node)) << node;
+        }
+    }
+    EXPECT_FALSE(cost.count(1)); // aislado
+}
+
+TEST_F(GeoRoutingTest, IsochroneBandsAreDisjointRings) {
+    CsrGraph csr(grid);
+    std::vector<double> budgets = {0.5, 1.0, 2.0, 4.0};
+    SearchWorkspace workspace;
+    std::vector<ReachableStop> reached;
+    std::vector<size_t> offsets;
+    TransportAlgorithms::isochrone_bands(csr, 8, budgets, workspace, reached, offsets);
+
+    ASSERT_EQ(offsets.size(), budgets.size() + 1);
+    EXPECT_EQ(offsets.back(), reached.size());
+    for (size_t b = 0; b < budgets.size(); ++b) {
+        EXPECT_EQ(offsets[b + 1], TransportAlgorithms::isochrone(csr, 8, budgets[b]).size());
+        for (size_t i = offsets[b]; i < offsets[b + 1]; ++i) {
+            EXPECT_LE(reached[i].cost, budgets[b]);
+            if (b > 0) {
+                EXPECT_GT(reached[i].cost, budgets[b - 1]);
+            }
+        }
+    }
+
+    ThreadPool pool(2);
+    auto counts = TransportAlgorithms::catchment_counts(csr, budgets, pool);
+    ASSERT_EQ(counts.size(), csr.node_count() * budgets.size());
+    int row = csr.index_of(8);
+    for (size_t b = 0; b < budgets.size(); ++b) EXPECT_EQ(counts[row * budgets.size() + b], offsets[b + 1]);
+    EXPECT_EQ(counts[csr.index_of(1) * budgets.size() + budgets.size() - 1], 1u);
+}
+
+TEST_F(AlgorithmsTest, SpatialIndexMatchesLinearScan) {
+    SpatialIndex index(0.3);
+    std::vector<std::pair<double, double>> points;
+    for (int i = 0; i < 400; ++i) {
+        // Malla irregular alrededor de Cusco
+        double lat = -13.60 + (i % 20) * 0.0041 + (i % 7) * 0.0003;
+        double lon = -72.00 + (i / 20) * 0.0047 - (i % 5) * 0.0002;
+        points.emplace_back(lat, lon);
+        index.insert(i, lat, lon);
+    }
+
+    double lat = -13.555, lon = -71.953;
+    for (double radius : {0.0, 0.25, 1.0, 3.0, 50.0}) {
+        size_t expected = 0;
+        for (const auto& [plat, plon] : points) {
+            if (TransportAlgorithms::calculate_distance(lat, lon, plat, plon) <= radius) ++expected;
+        }
+        auto matches = index.within_radius(lat, lon, radius);
+        EXPECT_EQ(matches.size(), expected) << radius;
+        for (size_t i = 1; i < matches.size(); ++i) {
+            EXPECT_LE(matches[i - 1].distance_km, matches[i].distance_km);
+        }
+    }
+
+    auto nearest = index.nearest(lat, lon, 5);
+    ASSERT_EQ(nearest.size(), 5u);
+    auto within = index.within_radius(lat, lon, nearest.back().distance_km);
+    EXPECT_GE(within.size(), 5u);
+    EXPECT_EQ(within.front().id, nearest.front().id);
+
+    EXPECT_TRUE(index.remove(nearest.front().id));
+    EXPECT_FALSE(index.remove(nearest.front().id));
+    EXPECT_EQ(index.size(), 399u);
+    EXPECT_NE(index.nearest(lat, lon, 1).front().id, nearest.front().id);
+}
+
+TEST_F(AlgorithmsTest, BatchHaversineKernelsMatchScalar) {
+    CoordinateBlock block;
+    std::vector<std::pair<double, double>> points;
+    for (int i = 0; i < 103; ++i) { // tamaño impar: ejercita la cola escalar
+        double lat = -13.53 + (i % 11) * 0.013 - (i % 3) * 0.4;
+        double lon = -71.97 + (i % 13) * 0.017 + (i % 4) * 0.9;
+        if (i % 17 == 0) lat += 40.0; // carriles lejanos: fuera de la serie de asin
+        points.emplace_back(lat, lon);
+        block.push_back(lat, lon);
+    }
+    points.emplace_back(-13.53, -71.97); // distancia cero
+    block.push_back(-13.53, -71.97);
+
+    std::vector<double> out(block.size());
+    for (auto kernel : {DistanceKernel::SCALAR, DistanceKernel::SSE2, DistanceKernel::AVX2, DistanceKernel::AUTO}) {
+        haversine_batch(-13.53, -71.97, block, out.data(), kernel);
+        for (size_t i = 0; i < points.size(); ++i) {
+            double expected = TransportAlgorithms::calculate_distance(-13.53, -71.97,
+                                                                      points[i].first, points[i].second);
+            EXPECT_NEAR(out[i], expected, 1e-9 * std::max(1.0, expected)) << i;
+        }
+    }
+    EXPECT_NEAR(out.back(), 0.0, 1e-9);
+
+    block.swap_remove(0);
+    EXPECT_EQ(block.size(), points.size() - 1);
+}
+
+TEST_F(AlgorithmsTest, EquirectangularWithinDocumentedBound) {
+    CoordinateBlock block;
+    for (int i = 0; i < 200; ++i) {
+        // Hasta ~20 km alrededor de latitudes de -70° a 70°
+        double lat0 = -70.0 + (i % 15) * 10.0;
+        block.push_back(lat0 + (i % 9 - 4) * 0.04, 0.3 + (i % 7 - 3) * 0.04);
+    }
+    for (double lat0 : {-69.9, -13.53, 0.0, 45.0, 69.9}) {
+        std::vector<double> exact(block.size()), approx(block.size());
+        haversine_batch(lat0, 0.3, block, exact.data(), DistanceKernel::SCALAR);
+        equirectangular_batch(lat0, 0.3, block, approx.data());
+        for (size_t i = 0; i < block.size(); ++i) {
+            if (exact[i] > 20.0) continue;
+            EXPECT_LE(std::abs(approx[i] - exact[i]), 1e-5 * exact[i] + 1e-12) << lat0 << " " << i;
+        }
+    }
+}
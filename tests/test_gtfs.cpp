@@ -0,0 +1,249 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include "transport/gtfs_importer.h"
+#include "transport/transport.h"
+#include "infra/csv_reader.h"
+#include "infra/db.h"
+#include "infra/logger.h"
+
+using namespace urban_transport;
+
+namespace {
+
+void write_file(const std::string& path, const std::string& content) {
+    std::ofstream out(path, std::ios::binary);
+    out << content;
+}
+
+} // namespace
+
+TEST(CsvReaderTest, ParsesQuotedFieldsWithoutCopies) {
+    std::string path = "test_csv_reader.csv";
+    write_file(path, "\xEF\xBB\xBF" "id, name ,note\r\n"
+                     "1,\"Plaza, centro\",\"dice \"\"hola\"\"\"\r\n"
+                     "\r\n"
+                     "2,\"dos\nlíneas\",\n"
+                     "3,sin comillas,último");
+
+    CsvReader reader;
+    ASSERT_TRUE(reader.open(path));
+    EXPECT_EQ(reader.column("id"), 0);
+    EXPECT_EQ(reader.column("name"), 1);
+    EXPECT_EQ(reader.column("missing"), -1);
+
+    std::vector<std::string_view> fields;
+    ASSERT_TRUE(reader.next(fields));
+    ASSERT_EQ(fields.size(), 3u);
+    EXPECT_EQ(fields[1], "Plaza, centro");
+    EXPECT_EQ(fields[2], "dice \"hola\"");
+
+    ASSERT_TRUE(reader.next(fields));
+    ASSERT_EQ(fields.size(), 3u);
+    EXPECT_EQ(fields[1], "dos\nlíneas");
+    EXPECT_TRUE(fields[2].empty());
+
+    ASSERT_TRUE(reader.next(fields));
+    EXPECT_EQ(fields[2], "último");
+    EXPECT_FALSE(reader.next(fields));
+    reader.close();
+
+    write_file(path, "");
+    ASSERT_TRUE(reader.open(path));
+    EXPECT_TRUE(reader.header().empty());
+    EXPECT_FALSE(reader.next(fields));
+    std::remove(path.c_str());
+}
+
+class GtfsImporterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Logger::get_instance().initialize();
+        db_path = "test_gtfs.db";
+        feed_path = "test_gtfs_feed";
+        std::remove(db_path.c_str());
+        std::filesystem::remove_all(feed_path);
+        std::filesystem::create_directory(feed_path);
+        create_test_schema();
+        write_feed();
+        ASSERT_TRUE(importer.initialize(db_path));
+    }
+
+    void TearDown() override {
+        Logger::get_instance().shutdown();
+        std::remove(db_path.c_str());
+        std::filesystem::remove_all(feed_path);
+    }
+
+    void create_test_schema() {
+        std::string sql = R"(
+CREATE TABLE IF NOT EXISTS stops (
+    id INTEGER PRIMARY KEY,
+    name TEXT NOT NULL,
+    latitude REAL NOT NULL,
+    longitude REAL NOT NULL
+);
+
+CREATE TABLE IF NOT EXISTS routes (
+    id INTEGER PRIMARY KEY,
+    name TEXT NOT NULL,
+    transport_type TEXT NOT NULL CHECK (transport_type IN ('bus', 'metro', 'train', 'tram'))
+);
+
+CREATE TABLE IF NOT EXISTS route_stops (
+    route_id INTEGER,
+    stop_id INTEGER,
+    sequence INTEGER NOT NULL,
+    PRIMARY KEY (route_id, stop_id)
+);
+
+CREATE TABLE IF NOT EXISTS trips (
+    id INTEGER PRIMARY KEY,
+    route_id INTEGER NOT NULL,
+    start_time TEXT NOT NULL,
+    end_time TEXT NOT NULL
+);
+
+CREATE TABLE IF NOT EXISTS trip_stops (
+    trip_id INTEGER,
+    stop_id INTEGER,
+    arrival_time TEXT NOT NULL,
+    sequence INTEGER NOT NULL,
+    PRIMARY KEY (trip_id, stop_id)
+);
+
+INSERT INTO stops (id, name, latitude, longitude) VALUES (1, 'Existente', -13.5, -71.9);
+)";
+
+        Database db;
+        if (db.connect(db_path)) {
+            db.execute(sql);
+            db.disconnect();
+        }
+    }
+
+    void write_feed() {
+        write_file(feed_path + "/stops.txt",
+                   "\xEF\xBB\xBF" "stop_id,stop_name,stop_lat,stop_lon\r\n"
+                   "PA,Plaza de Armas,-13.5167,-71.9781\r\n"
+                   "SB,\"San Blas, barrio\",-13.5145,-71.9750\r\n"
+                   "SP,\"San \"\"Pedro\"\"\",-13.5210,-71.9840\r\n"
+                   "WQ,Wanchaq,-13.5260,-71.9660\r\n"
+                   "XX,Sin coordenadas,,\r\n");
+        write_file(feed_path + "/routes.txt",
+                   "route_id,agency_id,route_short_name,route_long_name,route_type\n"
+                   "L1,A,L1,Línea 1,3\n"
+                   "T1,A,,Tranvía Centro,0\n");
+        write_file(feed_path + "/trips.txt",
+                   "route_id,service_id,trip_id\n"
+                   "L1,S,L1-0800\n"
+                   "L1,S,L1-0900\n"
+                   "T1,S,T1-0700\n"
+                   "ZZ,S,huerfano\n");
+        write_file(feed_path + "/stop_times.txt",
+                   "trip_id,arrival_time,departure_time,stop_id,stop_sequence\n"
+                   "L1-0800,08:00:00,08:00:00,PA,1\n"
+                   "L1-0800,08:10:00,08:10:00,SP,2\n"
+                   "L1-0800,,,XX,3\n"
+                   "L1-0800,8:20:00,8:20:00,WQ,4\n"
+                   "L1-0900,09:20:00,09:20:00,WQ,3\n"
+                   "L1-0900,09:00:00,09:00:00,PA,1\n"
+                   "T1-0700,25:05:00,25:05:00,SB,1\n"
+                   "desconocido,08:00:00,08:00:00,PA,1\n");
+    }
+
+    std::string query_text(const std::string& sql) {
+        Database db;
+        std::string result;
+        if (db.connect(db_path)) {
+            db.query_rows(sql, [&](const RowView& row) {
+                if (!result.empty()) result += "|";
+                result += std::string(row.get_text(0));
+                return true;
+            });
+            db.disconnect();
+        }
+        return result;
+    }
+
+    GtfsImporter importer;
+    std::string db_path;
+    std::string feed_path;
+};
+
+TEST_F(GtfsImporterTest, ImportsFeedIntoSchema) {
+    importer.set_batch_size(2);
+    GtfsImportReport report = importer.import_directory(feed_path);
+    ASSERT_TRUE(report.success) << report.error;
+    ASSERT_EQ(report.files.size(), 4u);
+    EXPECT_EQ(report.files[0].file, "stops.txt");
+    EXPECT_EQ(report.files[0].rows, 4u);
+    EXPECT_EQ(report.files[0].skipped, 1u);
+    EXPECT_EQ(report.files[2].skipped, 1u);
+    EXPECT_EQ(report.files[3].rows, 6u);
+    EXPECT_EQ(report.files[3].skipped, 2u);
+    EXPECT_GT(report.files[3].bytes, 0u);
+
+    // Los ids continúan tras los existentes
+    EXPECT_EQ(query_text("SELECT name FROM stops ORDER BY id"),
+              "Existente|Plaza de Armas|San Blas, barrio|San \"Pedro\"|Wanchaq");
+    EXPECT_EQ(query_text("SELECT name || ':' || transport_type FROM routes ORDER BY id"),
+              "L1:bus|Tranvía Centro:tram");
+    EXPECT_EQ(query_text("SELECT start_time || '-' || end_time FROM trips ORDER BY id"),
+              "08:00:00-08:20:00|09:00:00-09:20:00|25:05:00-25:05:00");
+    EXPECT_EQ(query_text("SELECT s.name FROM route_stops rs JOIN stops s ON s.id = rs.stop_id "
+                         "WHERE rs.route_id = 1 ORDER BY rs.sequence"),
+              "Plaza de Armas|San \"Pedro\"|Wanchaq");
+
+    TransportSystem system;
+    ASSERT_TRUE(system.initialize(db_path));
+    Journey journey = system.earliest_arrival(2, 5, "07:59:00", 0);
+    ASSERT_TRUE(journey.found());
+    EXPECT_EQ(format_service_time(journey.arrival_time), "08:20:00");
+    system.shutdown();
+}
+
+TEST_F(GtfsImporterTest, ReportsMissingFilesAndColumns) {
+    std::filesystem::remove(feed_path + "/stop_times.txt");
+    GtfsImportReport report = importer.import_directory(feed_path);
+    EXPECT_FALSE(report.success);
+    EXPECT_EQ(report.files.size(), 3u);
+    EXPECT_NE(report.error.find("stop_times.txt"), std::string::npos);
+
+    write_file(feed_path + "/stops.txt", "stop_id,stop_name\nA,Sin coordenadas\n");
+    report = importer.import_directory(feed_path);
+    EXPECT_FALSE(report.success);
+    EXPECT_NE(report.error.find("stop_lat"), std::string::npos);
+}
+
+TEST_F(GtfsImporterTest, ImportsTripsWithInterleavedStopTimes) {
+    // Las filas de L1-0800 vienen partidas por las de otros viajes
+    write_file(feed_path + "/stop_times.txt",
+               "trip_id,arrival_time,departure_time,stop_id,stop_sequence\n"
+               "L1-0800,08:00:00,08:00:00,PA,1\n"
+               "T1-0700,07:00:00,07:00:00,SB,1\n"
+               "L1-0800,08:10:00,08:10:00,SP,2\n"
+               "L1-0900,09:00:00,09:00:00,PA,1\n"
+               "L1-0800,08:20:00,08:20:00,WQ,3\n"
+               "T1-0700,07:05:00,07:05:00,PA,2\n");
+    GtfsImportReport report = importer.import_directory(feed_path);
+    ASSERT_TRUE(report.success) << report.error;
+    EXPECT_EQ(report.files[3].rows, 6u);
+    EXPECT_EQ(report.files[3].skipped, 0u);
+
+    EXPECT_EQ(query_text("SELECT s.name FROM route_stops rs JOIN stops s ON s.id = rs.stop_id "
+                         "WHERE rs.route_id = 1 ORDER BY rs.sequence"),
+              "Plaza de Armas|San \"Pedro\"|Wanchaq");
+    EXPECT_EQ(query_text("SELECT s.name FROM route_stops rs JOIN stops s ON s.id = rs.stop_id "
+                         "WHERE rs.route_id = 2 ORDER BY rs.sequence"),
+              "San Blas, barrio|Plaza de Armas");
+    EXPECT_EQ(query_text("SELECT start_time || '-' || end_time FROM trips ORDER BY id"),
+              "08:00:00-08:20:00|09:00:00-09:00:00|07:00:00-07:05:00");
+
+    // El grafo tiene todos los tramos de la ruta
+    TransportSystem system;
+    ASSERT_TRUE(system.initialize(db_path));
+    EXPECT_EQ(system.find_shortest_path(2, 5), (std::vector<int>{2, 4, 5}));
+    system.shutdown();
+}
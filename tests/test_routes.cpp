@@ -94,4 +94,74 @@ TEST_F(RouteServiceTest, FindRoutesByType) {
     for (const auto& route : bus_routes) {
         EXPECT_EQ(route.transport_type, "bus");
     }
-}
\ No newline at end of file
+}
+TEST_F(RouteServiceTest, CreateRoutesWithStopsInOneTransaction) {
+    std::vector<Route> routes = {Route(1, "Línea 1", "bus"), Route(2, "Línea 2", "bus")};
+    routes[0].stop_ids = {3, 1, 4};
+    routes[1].stop_ids = {2, 1};
+    ASSERT_TRUE(service.create_routes_with_stops(routes));
+    EXPECT_EQ(service.get_route_stops(1), (std::vector<int>{3, 1, 4}));
+    EXPECT_EQ(service.get_route_stops(2), (std::vector<int>{2, 1}));
+
+    // Una parada repetida viola la clave primaria: no se crea ninguna ruta
+    std::vector<Route> invalid = {Route(3, "Línea 3", "bus"), Route(4, "Línea 4", "bus")};
+    invalid[0].stop_ids = {5};
+    invalid[1].stop_ids = {6, 6};
+    EXPECT_FALSE(service.create_routes_with_stops(invalid));
+    EXPECT_EQ(service.get_route(3).id, 0);
+    EXPECT_TRUE(service.get_route_stops(3).empty());
+}
+
+TEST_F(RouteServiceTest, AddStopAfterRemovalKeepsSequenceOrder) {
+    Route route(1, "Línea 1", "bus");
+    route.stop_ids = {1, 2, 3};
+    ASSERT_TRUE(service.create_routes_with_stops({route}));
+
+    // Contar paradas repetiría la secuencia 3; MAX(sequence) + 1 no
+    ASSERT_TRUE(service.remove_stop_from_route(1, 2));
+    ASSERT_TRUE(service.add_stop_to_route(1, 4));
+    EXPECT_EQ(service.get_route_stops(1), (std::vector<int>{1, 3, 4}));
+
+    ASSERT_TRUE(service.add_stop_to_route(5, 7));
+    EXPECT_EQ(service.get_route_stops(5), (std::vector<int>{7}));
+}
+
+TEST_F(RouteServiceTest, ReadsServedFromEntityCache) {
+    Route route(1, "Línea 1", "bus");
+    route.stop_ids = {1, 2};
+    ASSERT_TRUE(service.create_routes_with_stops({route, Route(2, "Línea 2", "tram")}));
+
+    // La primera lectura carga la tabla; las siguientes no van a SQLite
+    EXPECT_EQ(service.get_all_routes().size(), 2u);
+    EXPECT_EQ(service.get_route(1).stop_ids, (std::vector<int>{1, 2}));
+    EXPECT_EQ(service.get_route(9).id, 0);
+    EntityStoreStats stats = service.cache_stats();
+    EXPECT_TRUE(stats.loaded);
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.hits, 2u);
+    EXPECT_EQ(stats.entries, 2u);
+    EXPECT_GT(stats.memory_bytes, 0u);
+
+    // Las escrituras del servicio mantienen la copia al día
+    ASSERT_TRUE(service.add_stop_to_route(1, 3));
+    ASSERT_TRUE(service.update_route(Route(1, "Línea 1A", "bus")));
+    ASSERT_TRUE(service.delete_route(2));
+    ASSERT_TRUE(service.create_route(Route(3, "Línea 3", "metro")));
+    Route updated = service.get_route(1);
+    EXPECT_EQ(updated.name, "Línea 1A");
+    EXPECT_EQ(updated.stop_ids, (std::vector<int>{1, 2, 3}));
+    EXPECT_EQ(service.get_route(2).id, 0);
+    EXPECT_EQ(service.find_routes_by_type("metro").size(), 1u);
+    EXPECT_GT(service.cache_stats().version, stats.version);
+    EXPECT_EQ(service.cache_stats().misses, 1u);
+
+    // Otra conexión: visible tras invalidar
+    Database db;
+    ASSERT_TRUE(db.connect(db_path));
+    ASSERT_TRUE(db.execute("INSERT INTO routes (id, name, transport_type) VALUES (4, 'Externa', 'bus')"));
+    db.disconnect();
+    EXPECT_EQ(service.get_route(4).id, 0);
+    service.invalidate_cache();
+    EXPECT_EQ(service.get_route(4).name, "Externa");
+    EXPECT_EQ(service.get_all_routes().size(), 3u);
+}
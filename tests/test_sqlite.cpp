@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <thread>
+#include <atomic>
+#include "infra/sqlite_wrapper.h"
+#include "infra/logger.h"
+
+using namespace urban_transport;
+
+class SQLiteWrapperTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Logger::get_instance().initialize();
+        db_path = "test_sqlite.db";
+        std::remove(db_path.c_str());
+        ASSERT_TRUE(sqlite.open(db_path));
+        ASSERT_TRUE(sqlite.execute(
+            "CREATE TABLE stops (id INTEGER PRIMARY KEY, name TEXT NOT NULL);"
+            "INSERT INTO stops (id, name) VALUES (1, 'Plaza de Armas'), (2, 'San Blas');"));
+    }
+
+    void TearDown() override {
+        sqlite.close();
+        Logger::get_instance().shutdown();
+        std::remove(db_path.c_str());
+    }
+
+    std::string name_of(int id) {
+        std::string name;
+        sqlite.query_with_params("SELECT name FROM stops WHERE id = ?", {std::to_string(id)},
+                                 [&](const std::vector<std::string>& row) {
+                                     name = row[0];
+                                     return false;
+                                 });
+        return name;
+    }
+
+    SQLiteWrapper sqlite;
+    std::string db_path;
+};
+
+TEST_F(SQLiteWrapperTest, ReusesPreparedStatements) {
+    EXPECT_EQ(name_of(1), "Plaza de Armas");
+    EXPECT_EQ(name_of(2), "San Blas");
+    EXPECT_EQ(name_of(3), "");
+
+    auto stats = sqlite.statement_cache_stats();
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.hits, 2u);
+    EXPECT_EQ(stats.size, 1u);
+
+    // Los parámetros se limpian al reutilizar: la inserción no ve los anteriores
+    ASSERT_TRUE(sqlite.execute_with_params("INSERT INTO stops (id, name) VALUES (?, ?)", {"3", "San Pedro"}));
+    EXPECT_FALSE(sqlite.execute_with_params("INSERT INTO stops (id, name) VALUES (?, ?)", {"4"}));
+    EXPECT_EQ(name_of(3), "San Pedro");
+    EXPECT_EQ(name_of(4), "");
+}
+
+TEST_F(SQLiteWrapperTest, NestedQueryWithSameSqlGetsOwnStatement) {
+    std::vector<std::string> pairs;
+    std::string sql = "SELECT name FROM stops ORDER BY id";
+    sqlite.query(sql, [&](const std::vector<std::string>& outer) {
+        sqlite.query(sql, [&](const std::vector<std::string>& inner) {
+            pairs.push_back(outer[0] + "/" + inner[0]);
+            return true;
+        });
+        return true;
+    });
+    EXPECT_EQ(pairs.size(), 4u);
+    EXPECT_EQ(sqlite.statement_cache_stats().size, 1u);
+}
+
+TEST_F(SQLiteWrapperTest, EvictsLeastRecentlyUsed) {
+    sqlite.set_statement_cache_capacity(2);
+    auto count = [&](const std::string& sql) {
+        sqlite.query(sql, [](const std::vector<std::string>&) { return true; });
+    };
+    count("SELECT id FROM stops");
+    count("SELECT name FROM stops");
+    count("SELECT id FROM stops");   // acierto: pasa a ser la más reciente
+    count("SELECT * FROM stops");    // expulsa "SELECT name"
+    count("SELECT name FROM stops"); // fallo
+
+    auto stats = sqlite.statement_cache_stats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 4u);
+    EXPECT_EQ(stats.size, 2u);
+
+    sqlite.set_statement_cache_capacity(0);
+    EXPECT_EQ(sqlite.statement_cache_stats().size, 0u);
+    count("SELECT id FROM stops");
+    EXPECT_EQ(sqlite.statement_cache_stats().size, 0u);
+}
+
+TEST_F(SQLiteWrapperTest, TypedBindingAndRowView) {
+    // Un std::string temporal dejaría la vista colgando: no compila
+    static_assert(!std::is_constructible_v<SqlParam, std::string&&>);
+    static_assert(std::is_constructible_v<SqlParam, const std::string&>);
+    ASSERT_TRUE(sqlite.execute("CREATE TABLE samples (id INTEGER, value REAL, label TEXT);"));
+    std::string label = "Wanchaq";
+    ASSERT_TRUE(sqlite.execute_with_values("INSERT INTO samples VALUES (?, ?, ?)",
+                                           {int64_t(1) << 40, -13.5260123456789, label}));
+    ASSERT_TRUE(sqlite.execute_with_values("INSERT INTO samples VALUES (?, ?, ?)", {2, 0.5, nullptr}));
+
+    std::vector<std::string> seen;
+    ASSERT_TRUE(sqlite.query_rows("SELECT id, value, label FROM samples WHERE id >= ? ORDER BY id", {1},
+                                  [&](const RowView& row) {
+        EXPECT_EQ(row.column_count(), 3);
+        if (row.get_int(0) == 2) {
+            EXPECT_DOUBLE_EQ(row.get_double(1), 0.5);
+            EXPECT_TRUE(row.is_null(2));
+            EXPECT_TRUE(row.get_text(2).empty());
+        } else {
+            EXPECT_EQ(row.get_int64(0), int64_t(1) << 40);
+            // Sin pasar por texto no se pierden decimales
+            EXPECT_DOUBLE_EQ(row.get_double(1), -13.5260123456789);
+        }
+        seen.emplace_back(row.get_text(2));
+        return true;
+    }));
+    EXPECT_EQ(seen, (std::vector<std::string>{"", "Wanchaq"}));
+
+    // El texto vacío se vincula como "" y no como NULL
+    ASSERT_TRUE(sqlite.execute_with_values("INSERT INTO samples VALUES (?, ?, ?)", {3, 1.0, std::string_view()}));
+    bool is_null = true;
+    sqlite.query_rows("SELECT label FROM samples WHERE id = ?", {3}, [&](const RowView& row) {
+        is_null = row.is_null(0);
+        return false;
+    });
+    EXPECT_FALSE(is_null);
+}
+
+TEST_F(SQLiteWrapperTest, ConcurrentQueriesShareStatementCache) {
+    constexpr int THREADS = 4;
+    constexpr int QUERIES = 200;
+    std::atomic<int> wrong{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < THREADS; ++t) {
+        readers.emplace_back([&, t] {
+            for (int i = 0; i < QUERIES; ++i) {
+                int id = 1 + (i + t) % 2;
+                std::string expected = id == 1 ? "Plaza de Armas" : "San Blas";
+                std::string name;
+                sqlite.query_rows("SELECT name FROM stops WHERE id = ?", {id}, [&](const RowView& row) {
+                    name = std::string(row.get_text(0));
+                    return false;
+                });
+                if (name != expected) ++wrong;
+            }
+        });
+    }
+    for (auto& reader : readers) reader.join();
+
+    EXPECT_EQ(wrong.load(), 0);
+    auto stats = sqlite.statement_cache_stats();
+    EXPECT_EQ(stats.hits + stats.misses, static_cast<size_t>(THREADS * QUERIES));
+    EXPECT_EQ(stats.size, 1u);
+}
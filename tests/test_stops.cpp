@@ -84,4 +84,50 @@ TEST_F(StopServiceTest, UpdateStop) {
 
     Stop updated = service.get_stop(1);
     EXPECT_EQ(updated.name, "Parada Actualizada");
-}
\ No newline at end of file
+}
+TEST_F(StopServiceTest, NearbyStopsSortedByDistance) {
+    auto nearby = service.find_nearby_stops(40.7128, -74.0060, 5.0);
+    ASSERT_EQ(nearby.size(), 3u);
+    EXPECT_EQ(nearby[0].id, 1);
+
+    EXPECT_EQ(service.find_nearby_stops(40.7128, -74.0060, 0.1).size(), 1u);
+}
+
+TEST_F(StopServiceTest, NearestStops) {
+    auto nearest = service.find_nearest_stops(40.7230, -74.0162, 2);
+    ASSERT_EQ(nearest.size(), 2u);
+    EXPECT_EQ(nearest[0].id, 2);
+    EXPECT_EQ(nearest[1].id, 1);
+    EXPECT_EQ(nearest[0].name, "Parada 2");
+
+    EXPECT_EQ(service.find_nearest_stops(0.0, 0.0, 10).size(), 3u);
+}
+
+TEST_F(StopServiceTest, SpatialIndexFollowsChanges) {
+    EXPECT_EQ(service.find_nearby_stops(40.7028, -73.9960, 0.1).size(), 1u);
+
+    EXPECT_TRUE(service.create_stop(Stop(4, "Parada 4", 40.7029, -73.9961)));
+    EXPECT_EQ(service.find_nearby_stops(40.7028, -73.9960, 0.1).size(), 2u);
+
+    EXPECT_TRUE(service.update_stop(Stop(4, "Parada 4", 41.0, -73.0)));
+    EXPECT_EQ(service.find_nearby_stops(40.7028, -73.9960, 0.1).size(), 1u);
+    EXPECT_EQ(service.find_nearest_stops(41.0, -73.0, 1)[0].id, 4);
+
+    EXPECT_TRUE(service.delete_stop(3));
+    EXPECT_TRUE(service.find_nearby_stops(40.7028, -73.9960, 0.1).empty());
+}
+
+TEST_F(StopServiceTest, CreateStopsInOneTransaction) {
+    EXPECT_EQ(service.find_nearby_stops(40.7028, -73.9960, 0.1).size(), 1u);
+
+    std::vector<Stop> stops = {Stop(20, "Parada 20", 40.7029, -73.9961), Stop(21, "Parada 21", 40.8, -74.1)};
+    ASSERT_TRUE(service.create_stops(stops));
+    EXPECT_EQ(service.get_stop(21).name, "Parada 21");
+    EXPECT_EQ(service.find_nearby_stops(40.7028, -73.9960, 0.1).size(), 2u);
+
+    // El id 1 ya existe: la parada 30 tampoco se crea
+    EXPECT_FALSE(service.create_stops({Stop(30, "Parada 30", 40.0, -74.0), Stop(1, "Duplicada", 40.0, -74.0)}));
+    EXPECT_EQ(service.get_stop(30).id, 0);
+    EXPECT_EQ(service.get_stop(1).name, "Parada 1");
+    EXPECT_TRUE(service.find_nearby_stops(40.0, -74.0, 0.1).empty());
+}
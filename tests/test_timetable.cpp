@@ -0,0 +1,224 @@
+#include <gtest/gtest.h>
+#include "core/algorithms.h"
+#include "core/service_time.h"
+#include "core/timetable.h"
+#include "core/trip_interval_index.h"
+#include "core/departure_board.h"
+
+using namespace urban_transport;
+
+class TimetableTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Línea 1 -> 2 -> 3, enlace 3 -> 4 y un directo 1 -> 4 más lento
+        add_trip(10, {1, 2, 3}, {"08:00:00", "08:10:00", "08:20:00"});
+        add_trip(11, {1, 2, 3}, {"08:30:00", "08:40:00", "08:50:00"});
+        add_trip(20, {3, 4}, {"08:25:00", "08:40:00"});
+        add_trip(21, {3, 4}, {"08:55:00", "09:10:00"});
+        add_trip(30, {1, 4}, {"08:05:00", "09:20:00"});
+        timetable = Timetable(trips);
+    }
+
+    void add_trip(int id, const std::vector<int>& stops, const std::vector<std::string>& times) {
+        ScheduledTrip trip{id, stops, {}};
+        for (const auto& text : times) {
+            int seconds = 0;
+            parse_service_time(text, seconds);
+            trip.times.push_back(seconds);
+        }
+        trips.push_back(trip);
+    }
+
+    static int at(const std::string& text) {
+        int seconds = 0;
+        parse_service_time(text, seconds);
+        return seconds;
+    }
+
+    std::vector<ScheduledTrip> trips;
+    Timetable timetable;
+};
+
+TEST(ServiceTimeTest, ParsesAndFormats) {
+    int seconds = 0;
+    EXPECT_TRUE(parse_service_time("08:15:30", seconds));
+    EXPECT_EQ(seconds, 8 * 3600 + 15 * 60 + 30);
+    EXPECT_TRUE(parse_service_time("25:10", seconds));
+    EXPECT_EQ(seconds, 25 * 3600 + 10 * 60);
+    EXPECT_EQ(format_service_time(seconds), "25:10:00");
+
+    EXPECT_FALSE(parse_service_time("", seconds));
+    EXPECT_FALSE(parse_service_time("8", seconds));
+    EXPECT_FALSE(parse_service_time("08:75:00", seconds));
+    EXPECT_FALSE(parse_service_time("ab:cd", seconds));
+}
+
+TEST_F(TimetableTest, GroupsTripsIntoRoutes) {
+    EXPECT_EQ(timetable.stop_count(), 4u);
+    EXPECT_EQ(timetable.trip_count(), 5u);
+    EXPECT_EQ(timetable.route_count(), 3u);
+
+    int stop_three = timetable.index_of(3);
+    EXPECT_EQ(timetable.stop_route_end(stop_three) - timetable.stop_route_begin(stop_three), 2u);
+    EXPECT_EQ(timetable.index_of(99), -1);
+}
+
+TEST_F(TimetableTest, OvertakingTripOpensNewRoute) {
+    add_trip(12, {1, 2, 3}, {"08:35:00", "08:38:00", "08:45:00"}); // adelanta al 11
+    Timetable with_express(trips);
+    EXPECT_EQ(with_express.route_count(), 4u);
+
+    Journey journey = TransportAlgorithms::raptor_earliest_arrival(with_express, 1, 3, at("08:31:00"), 0);
+    ASSERT_TRUE(journey.found());
+    EXPECT_EQ(journey.arrival_time, at("08:45:00"));
+    EXPECT_EQ(journey.legs.front().trip_id, 12);
+}
+
+TEST_F(TimetableTest, RaptorRespectsTransferLimit) {
+    Journey direct = TransportAlgorithms::raptor_earliest_arrival(timetable, 1, 4, at("08:00:00"), 0);
+    ASSERT_TRUE(direct.found());
+    EXPECT_EQ(direct.arrival_time, at("09:20:00"));
+    ASSERT_EQ(direct.legs.size(), 1u);
+    EXPECT_EQ(direct.legs[0].trip_id, 30);
+
+    Journey transfer = TransportAlgorithms::raptor_earliest_arrival(timetable, 1, 4, at("08:00:00"), 1);
+    ASSERT_TRUE(transfer.found());
+    EXPECT_EQ(transfer.arrival_time, at("08:40:00"));
+    ASSERT_EQ(transfer.legs.size(), 2u);
+    EXPECT_EQ(transfer.transfers(), 1u);
+    EXPECT_EQ(transfer.legs[0].trip_id, 10);
+    EXPECT_EQ(transfer.legs[0].from_stop, 1);
+    EXPECT_EQ(transfer.legs[0].to_stop, 3);
+    EXPECT_EQ(transfer.legs[1].trip_id, 20);
+    EXPECT_EQ(transfer.legs[1].departure_time, at("08:25:00"));
+}
+
+TEST_F(TimetableTest, RaptorWaitsForLaterTrips) {
+    Journey journey = TransportAlgorithms::raptor_earliest_arrival(timetable, 1, 4, at("08:06:00"), 2);
+    ASSERT_TRUE(journey.found());
+    EXPECT_EQ(journey.arrival_time, at("09:10:00"));
+    EXPECT_EQ(journey.legs.front().trip_id, 11);
+    EXPECT_EQ(journey.legs.back().trip_id, 21);
+
+    EXPECT_FALSE(TransportAlgorithms::raptor_earliest_arrival(timetable, 1, 4, at("09:00:00"), 2).found());
+    EXPECT_FALSE(TransportAlgorithms::raptor_earliest_arrival(timetable, 4, 1, at("08:00:00"), 2).found());
+    EXPECT_FALSE(TransportAlgorithms::raptor_earliest_arrival(timetable, 1, 99, at("08:00:00"), 2).found());
+}
+
+TEST_F(TimetableTest, ConnectionsSortedByDeparture) {
+    ConnectionTable connections(trips);
+    EXPECT_EQ(connections.connection_count(), 7u);
+    EXPECT_EQ(connections.trip_count(), 5u);
+    for (size_t i = 1; i < connections.connection_count(); ++i) {
+        EXPECT_LE(connections.connection(i - 1).departure_time, connections.connection(i).departure_time);
+    }
+    EXPECT_EQ(connections.connection(connections.first_departure(at("08:06:00"))).departure_time,
+              at("08:10:00"));
+}
+
+TEST_F(TimetableTest, CsaMatchesRaptorWithoutTransferLimit) {
+    ConnectionTable connections(trips);
+    for (const char* time : {"07:00:00", "08:00:00", "08:06:00", "08:31:00", "09:00:00"}) {
+        for (int from = 1; from <= 4; ++from) {
+            for (int to = 1; to <= 4; ++to) {
+                Journey csa = TransportAlgorithms::csa_earliest_arrival(connections, from, to, at(time));
+                Journey raptor = TransportAlgorithms::raptor_earliest_arrival(timetable, from, to, at(time), 4);
+                EXPECT_EQ(csa.arrival_time, raptor.arrival_time) << from << "->" << to << " " << time;
+            }
+        }
+    }
+
+    Journey journey = TransportAlgorithms::csa_earliest_arrival(connections, 1, 4, at("08:00:00"));
+    ASSERT_EQ(journey.legs.size(), 2u);
+    EXPECT_EQ(journey.legs[0].trip_id, 10);
+    EXPECT_EQ(journey.legs[0].to_stop, 3);
+    EXPECT_EQ(journey.legs[1].trip_id, 20);
+}
+
+TEST_F(TimetableTest, CsaProfileKeepsParetoDepartures) {
+    ConnectionTable connections(trips);
+    auto profile = TransportAlgorithms::csa_profile(connections, 1, 4, at("07:00:00"), at("09:00:00"));
+
+    // 08:05 directo (09:20) queda dominado por 08:30 vía 3 (09:10)
+    ASSERT_EQ(profile.size(), 2u);
+    EXPECT_EQ(profile[0].departure_time, at("08:00:00"));
+    EXPECT_EQ(profile[0].arrival_time, at("08:40:00"));
+    EXPECT_EQ(profile[1].departure_time, at("08:30:00"));
+    EXPECT_EQ(profile[1].arrival_time, at("09:10:00"));
+
+    // La dominancia considera salidas posteriores a la ventana
+    auto window = TransportAlgorithms::csa_profile(connections, 1, 4, at("08:01:00"), at("08:10:00"));
+    EXPECT_TRUE(window.empty());
+
+    auto direct = TransportAlgorithms::csa_profile(connections, 2, 3, at("08:00:00"), at("09:00:00"));
+    ASSERT_EQ(direct.size(), 2u);
+    EXPECT_EQ(direct[0].departure_time, at("08:10:00"));
+    EXPECT_EQ(direct[1].arrival_time, at("08:50:00"));
+}
+
+TEST(TripIntervalIndexTest, AnswersWindowQueries) {
+    const int h = 3600;
+    TripIntervalIndex index({{1, 8 * h, 9 * h}, {2, 6 * h, 12 * h}, {3, 10 * h, 11 * h},
+                             {4, 23 * h, 25 * h}, {5, 8 * h, 8 * h + 1800}});
+    EXPECT_EQ(index.max_duration(), 6 * h);
+
+    EXPECT_EQ(index.within(8 * h, 9 * h), (std::vector<int>{1, 5}));
+    EXPECT_EQ(index.overlapping(8 * h + 2700, 10 * h), (std::vector<int>{2, 1, 3}));
+    EXPECT_EQ(index.active_at(11 * h + 1800), (std::vector<int>{2}));
+    // 00:30 es 24:30 del día de servicio anterior
+    EXPECT_EQ(index.active_at(1800), (std::vector<int>{4}));
+    // El viaje 4 casa en los dos días y sale una sola vez
+    EXPECT_EQ(index.active_between(0, 23 * h + 1800), (std::vector<int>{2, 1, 5, 3, 4}));
+    EXPECT_TRUE(index.overlapping(10 * h, 9 * h).empty());
+
+    index.insert(1, 10 * h, 10 * h + 600);
+    index.insert(6, 10 * h, 10 * h + 900);
+    EXPECT_TRUE(index.remove(5));
+    EXPECT_FALSE(index.remove(5));
+    EXPECT_EQ(index.size(), 5u);
+    EXPECT_EQ(index.overlapping(8 * h, 10 * h), (std::vector<int>{2, 1, 3, 6}));
+    EXPECT_EQ(index.within(10 * h, 11 * h), (std::vector<int>{1, 3, 6}));
+}
+
+TEST(DepartureBoardTest, NextDeparturesPerStop) {
+    const int h = 3600;
+    DepartureBoard board;
+    board.add(1, 8 * h, 10, 1);
+    board.add(1, 8 * h + 600, 20, 2);
+    board.add(1, 7 * h, 11, 1);
+    board.add(1, 9 * h, 12, 1);
+    board.add(1, 24 * h + 900, 13, 3); // 00:15 del día siguiente
+    board.add(2, 8 * h, 10, 1);
+    EXPECT_EQ(board.departure_count(), 6u);
+
+    auto next = board.next_departures(1, 8 * h, 2);
+    ASSERT_EQ(next.size(), 2u);
+    EXPECT_EQ(next[0], (Departure{8 * h, 10, 1}));
+    EXPECT_EQ(next[1], (Departure{8 * h + 600, 20, 2}));
+    EXPECT_TRUE(board.next_departures(3, 8 * h, 5).empty());
+
+    // De madrugada sale primero el viaje del día de servicio anterior
+    auto early = board.next_departures(1, 600, 2);
+    ASSERT_EQ(early.size(), 2u);
+    EXPECT_EQ(early[0].trip_id, 13);
+    EXPECT_EQ(early[1].trip_id, 11);
+
+    auto groups = board.next_departures_by_route(1, 7 * h, 2 * h, 1);
+    ASSERT_EQ(groups.size(), 2u);
+    EXPECT_EQ(groups[0].route_id, 1);
+    EXPECT_EQ(groups[0].departures.size(), 1u);
+    EXPECT_EQ(groups[0].departures[0].trip_id, 11);
+    EXPECT_EQ(groups[1].route_id, 2);
+
+    // Cambios incrementales
+    board.add(1, 7 * h + 1800, 11, 1); // el viaje 11 pasa más tarde
+    board.set_trip_route(20, 4);
+    board.remove_trip(10);
+    EXPECT_EQ(board.departure_count(), 4u);
+    EXPECT_EQ(board.stop_count(), 1u);
+    next = board.next_departures(1, 7 * h, 3);
+    ASSERT_EQ(next.size(), 3u);
+    EXPECT_EQ(next[0], (Departure{7 * h + 1800, 11, 1}));
+    EXPECT_EQ(next[1], (Departure{8 * h + 600, 20, 4}));
+    EXPECT_EQ(next[2].trip_id, 12);
+}
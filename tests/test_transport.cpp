@@ -0,0 +1,329 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <atomic>
+#include <thread>
+#include "transport/transport.h"
+#include "core/algorithms.h"
+#include "core/network_snapshot.h"
+#include "infra/db.h"
+#include "infra/logger.h"
+
+using namespace urban_transport;
+
+class TransportSystemTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Logger::get_instance().initialize();
+        db_path = "test_transport.db";
+        std::remove(db_path.c_str());
+        create_test_schema();
+        ASSERT_TRUE(system.initialize(db_path));
+    }
+
+    void TearDown() override {
+        system.shutdown();
+        Logger::get_instance().shutdown();
+        std::remove(db_path.c_str());
+    }
+
+    void create_test_schema() {
+        std::string sql = R"(
+CREATE TABLE IF NOT EXISTS stops (
+    id INTEGER PRIMARY KEY,
+    name TEXT NOT NULL,
+    latitude REAL NOT NULL,
+    longitude REAL NOT NULL
+);
+
+CREATE TABLE IF NOT EXISTS routes (
+    id INTEGER PRIMARY KEY,
+    name TEXT NOT NULL,
+    transport_type TEXT NOT NULL
+);
+
+CREATE TABLE IF NOT EXISTS route_stops (
+    route_id INTEGER,
+    stop_id INTEGER,
+    sequence INTEGER NOT NULL,
+    PRIMARY KEY (route_id, stop_id)
+);
+
+CREATE TABLE IF NOT EXISTS trips (
+    id INTEGER PRIMARY KEY,
+    route_id INTEGER NOT NULL,
+    start_time TEXT NOT NULL,
+    end_time TEXT NOT NULL
+);
+
+CREATE TABLE IF NOT EXISTS trip_stops (
+    trip_id INTEGER,
+    stop_id INTEGER,
+    arrival_time TEXT NOT NULL,
+    sequence INTEGER NOT NULL,
+    PRIMARY KEY (trip_id, stop_id)
+);
+
+INSERT INTO stops (id, name, latitude, longitude) VALUES
+(1, 'Plaza de Armas', -13.5167, -71.9781),
+(2, 'San Blas', -13.5145, -71.9750),
+(3, 'San Pedro', -13.5210, -71.9840),
+(4, 'Wanchaq', -13.5260, -71.9660),
+(5, 'Aislada', -13.5400, -71.9000);
+
+INSERT INTO routes (id, name, transport_type) VALUES
+(1, 'Línea 1', 'bus'),
+(2, 'Línea 2', 'bus'),
+(3, 'Sin paradas', 'bus');
+
+INSERT INTO route_stops (route_id, stop_id, sequence) VALUES
+(1, 3, 2), (1, 1, 1), (1, 4, 3),
+(2, 2, 1), (2, 1, 2),
+(9, 4, 1), (9, 5, 2);
+
+INSERT INTO trips (id, route_id, start_time, end_time) VALUES
+(10, 1, '08:00:00', '08:20:00'),
+(20, 2, '07:50:00', '08:00:00');
+
+INSERT INTO trip_stops (trip_id, stop_id, arrival_time, sequence) VALUES
+(10, 1, '08:00:00', 1), (10, 3, '08:10:00', 2), (10, 4, '08:20:00', 3),
+(20, 2, '07:50:00', 1), (20, 1, '07:58:00', 2);
+)";
+
+        Database db;
+        if (db.connect(db_path)) {
+            db.execute(sql);
+            db.disconnect();
+        }
+    }
+
+    TransportSystem system;
+    std::string db_path;
+};
+
+TEST_F(TransportSystemTest, BulkLoadBuildsGraphInSequenceOrder) {
+    // Línea 1 en orden de secuencia: 1 -> 3 -> 4
+    auto path = system.find_shortest_path(2, 4);
+    EXPECT_EQ(path, (std::vector<int>{2, 1, 3, 4}));
+
+    // La ruta 9 no existe en routes: sus paradas no generan aristas
+    EXPECT_TRUE(system.find_shortest_path(4, 5).empty());
+
+    auto matrix = system.distance_matrix({1}, {3});
+    EXPECT_NEAR(matrix[0], TransportAlgorithms::calculate_distance(-13.5167, -71.9781, -13.5210, -71.9840), 1e-9);
+}
+
+TEST_F(TransportSystemTest, RoutesThroughStopFromIndex) {
+    auto routes = system.find_routes_through_stop(1);
+    ASSERT_EQ(routes.size(), 2u);
+    EXPECT_EQ(routes[0].name, "Línea 1");
+    EXPECT_EQ(routes[0].stop_ids, (std::vector<int>{1, 3, 4}));
+
+    auto direct = system.find_direct_routes(2, 1);
+    ASSERT_EQ(direct.size(), 1u);
+    EXPECT_EQ(direct[0].id, 2);
+    EXPECT_TRUE(system.find_direct_routes(4, 1).empty());
+}
+
+TEST_F(TransportSystemTest, EarliestArrivalUsesTimetable) {
+    Journey journey = system.earliest_arrival(2, 4, "07:45:00", 1);
+    ASSERT_TRUE(journey.found());
+    EXPECT_EQ(format_service_time(journey.arrival_time), "08:20:00");
+    ASSERT_EQ(journey.legs.size(), 2u);
+    EXPECT_EQ(journey.legs[0].trip_id, 20);
+    EXPECT_EQ(journey.legs[1].trip_id, 10);
+
+    EXPECT_FALSE(system.earliest_arrival(2, 4, "07:45:00", 0).found());
+    EXPECT_FALSE(system.earliest_arrival(2, 4, "no es una hora", 1).found());
+}
+
+TEST_F(TransportSystemTest, SnapshotStartupMatchesDatabase) {
+    std::string snapshot_path = "test_transport.snapshot";
+    std::remove(snapshot_path.c_str());
+
+    TransportSystem writer;
+    ASSERT_TRUE(writer.initialize(db_path, snapshot_path));
+    writer.shutdown();
+
+    NetworkSnapshot snapshot;
+    ASSERT_TRUE(snapshot.open(snapshot_path, database_fingerprint(db_path)));
+    EXPECT_EQ(snapshot.graph().node_count(), 5u);
+    EXPECT_EQ(snapshot.route_count(), 3u);
+    EXPECT_EQ(snapshot.route_index().routes_through(1), (std::vector<int>{1, 2}));
+
+    TransportSystem loaded;
+    ASSERT_TRUE(loaded.initialize(db_path, snapshot_path));
+    EXPECT_EQ(loaded.find_shortest_path(2, 4), system.find_shortest_path(2, 4));
+    EXPECT_EQ(loaded.distance_matrix({2}, {4}), system.distance_matrix({2}, {4}));
+
+    auto routes = loaded.find_routes_through_stop(1);
+    ASSERT_EQ(routes.size(), 2u);
+    EXPECT_EQ(routes[0].name, "Línea 1");
+    EXPECT_EQ(routes[0].transport_type, "bus");
+    EXPECT_EQ(routes[0].stop_ids, (std::vector<int>{1, 3, 4}));
+    EXPECT_EQ(loaded.find_direct_routes(2, 1).size(), 1u);
+
+    // La primera modificación copia la vista mapeada a un grafo editable
+    ASSERT_TRUE(loaded.update_edge_weight(1, 3, 100.0));
+    auto reachable = loaded.reachable_within(1, 1000.0);
+    ASSERT_FALSE(reachable.empty());
+    EXPECT_EQ(reachable.back().first, 4);
+    EXPECT_GT(reachable.back().second, 100.0);
+    loaded.shutdown();
+
+    std::remove(snapshot_path.c_str());
+}
+
+TEST_F(TransportSystemTest, SnapshotRejectedWhenCorruptOrStale) {
+    std::string snapshot_path = "test_transport.snapshot";
+    ASSERT_TRUE(system.save_snapshot(snapshot_path));
+    uint64_t fingerprint = database_fingerprint(db_path);
+    ASSERT_NE(fingerprint, 0u);
+
+    // Un byte alterado en los datos invalida la suma de control
+    {
+        std::fstream file(snapshot_path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekg(0, std::ios::end);
+        std::streamoff size = file.tellg();
+        file.seekp(size - 8);
+        file.put('\x7f');
+    }
+    NetworkSnapshot corrupt;
+    EXPECT_FALSE(corrupt.open(snapshot_path, fingerprint));
+
+    // Escribir en la base de datos deja la instantánea obsoleta
+    ASSERT_TRUE(system.save_snapshot(snapshot_path));
+    ASSERT_TRUE(system.add_stop(Stop(6, "Nueva", -13.5300, -71.9700)));
+    NetworkSnapshot stale;
+    EXPECT_FALSE(stale.open(snapshot_path, database_fingerprint(db_path)));
+
+    // Al arrancar se reconstruye desde la base de datos y se reescribe
+    TransportSystem rebuilt;
+    ASSERT_TRUE(rebuilt.initialize(db_path, snapshot_path));
+    EXPECT_EQ(rebuilt.find_shortest_path(2, 4), (std::vector<int>{2, 1, 3, 4}));
+    auto rebuilt_distance = rebuilt.distance_matrix({1}, {3});
+    rebuilt.shutdown();
+    NetworkSnapshot fresh;
+    EXPECT_TRUE(fresh.open(snapshot_path, database_fingerprint(db_path)));
+
+    EXPECT_FALSE(NetworkSnapshot().open("no_existe.snapshot", fingerprint));
+
+    // Con pesos ajustados en memoria no pasa por la red de la base de datos
+    ASSERT_TRUE(system.update_edge_weight(1, 3, 100.0));
+    ASSERT_TRUE(system.save_snapshot(snapshot_path));
+    NetworkSnapshot adjusted;
+    ASSERT_TRUE(adjusted.open(snapshot_path, database_fingerprint(db_path)));
+    EXPECT_TRUE(adjusted.adjusted_weights());
+    TransportSystem from_database;
+    ASSERT_TRUE(from_database.initialize(db_path, snapshot_path));
+    EXPECT_EQ(from_database.distance_matrix({1}, {3}), rebuilt_distance);
+    from_database.shutdown();
+    NetworkSnapshot rewritten;
+    ASSERT_TRUE(rewritten.open(snapshot_path, database_fingerprint(db_path)));
+    EXPECT_FALSE(rewritten.adjusted_weights());
+    std::remove(snapshot_path.c_str());
+}
+
+TEST_F(TransportSystemTest, ConcurrentSnapshotWritersUseOwnTemporaries) {
+    std::string snapshot_path = "test_transport.snapshot";
+    std::atomic<int> failures{0};
+    std::vector<std::thread> writers;
+    for (int w = 0; w < 4; ++w) {
+        writers.emplace_back([&] {
+            for (int i = 0; i < 10; ++i) {
+                if (!system.save_snapshot(snapshot_path)) ++failures;
+            }
+        });
+    }
+    for (auto& writer : writers) writer.join();
+
+    EXPECT_EQ(failures.load(), 0);
+    NetworkSnapshot snapshot;
+    EXPECT_TRUE(snapshot.open(snapshot_path, database_fingerprint(db_path)));
+    // No quedan temporales
+    int temporaries = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(".")) {
+        if (entry.path().extension() == ".tmp") ++temporaries;
+    }
+    EXPECT_EQ(temporaries, 0);
+    std::remove(snapshot_path.c_str());
+}
+
+TEST_F(TransportSystemTest, ReadersSeeWholeVersionsWhileWritersPublish) {
+    uint64_t initial = system.network_version();
+    std::atomic<bool> done{false};
+    std::atomic<int> failures{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([&] {
+            uint64_t last = 0;
+            while (!done.load()) {
+                uint64_t version = system.network_version();
+                if (version < last) ++failures; // las versiones nunca retroceden
+                last = version;
+                if (system.find_shortest_path(2, 4) != std::vector<int>{2, 1, 3, 4}) ++failures;
+                if (system.find_routes_through_stop(1).size() != 2) ++failures;
+            }
+        });
+    }
+
+    // EXPECT y no ASSERT: hay que parar y esperar a los lectores antes de salir
+    for (int i = 0; i < 20; ++i) {
+        EXPECT_TRUE(system.update_edge_weight(1, 3, 1.0 + i));
+        EXPECT_TRUE(system.add_stop(Stop(100 + i, "Nueva", -13.53, -71.97)));
+    }
+    done = true;
+    for (auto& reader : readers) reader.join();
+
+    EXPECT_EQ(failures.load(), 0);
+    EXPECT_EQ(system.network_version(), initial + 40);
+}
+
+TEST_F(TransportSystemTest, EntityLoadsDoNotInterleaveWithWriters) {
+    std::atomic<bool> done{false};
+    std::atomic<int> failures{0};
+
+    // Cada vuelta descarta las copias: get_stop carga mientras se escribe
+    std::thread reader([&] {
+        while (!done.load()) {
+            system.invalidate_entity_cache();
+            if (system.get_stop(1).name != "Plaza de Armas") ++failures;
+            if (system.get_route(1).stop_ids != std::vector<int>{1, 3, 4}) ++failures;
+        }
+    });
+
+    std::thread stop_writer([&] {
+        for (int i = 0; i < 30; ++i) {
+            if (!system.add_stop(Stop(200 + i, "Nueva", -13.53, -71.97))) ++failures;
+        }
+    });
+
+    // Las rutas impares repiten parada y fallan: su rollback no debe
+    // llevarse paradas de otro hilo
+    int rejected = 0;
+    for (int i = 0; i < 30; ++i) {
+        std::vector<int> stops = i % 2 == 0 ? std::vector<int>{1, 2} : std::vector<int>{1, 1};
+        Route route(10 + i, "Concurrente", "bus");
+        route.stop_ids = stops;
+        if (!system.add_route(route)) ++rejected;
+    }
+    stop_writer.join();
+    done = true;
+    reader.join();
+
+    EXPECT_EQ(failures.load(), 0);
+    EXPECT_EQ(rejected, 15);
+
+    // Las copias en memoria coinciden con la base de datos
+    auto cached_stops = system.get_all_stops().size();
+    auto cached_routes = system.get_all_routes().size();
+    system.invalidate_entity_cache();
+    EXPECT_EQ(system.get_all_stops().size(), 35u);
+    EXPECT_EQ(cached_stops, 35u);
+    EXPECT_EQ(system.get_all_routes().size(), 18u);
+    EXPECT_EQ(cached_routes, 18u);
+    EXPECT_EQ(system.get_route(11).id, 0);
+    EXPECT_EQ(system.get_route(12).stop_ids, (std::vector<int>{1, 2}));
+}
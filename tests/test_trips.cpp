@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include "transport/trip_service.h"
+#include "infra/db.h"
+#include "infra/logger.h"
+
+using namespace urban_transport;
+
+class TripServiceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Logger::get_instance().initialize();
+        db_path = "test_trips.db";
+        std::remove(db_path.c_str());
+        service.initialize(db_path);
+        create_test_schema();
+    }
+
+    void TearDown() override {
+        Logger::get_instance().shutdown();
+        std::remove(db_path.c_str());
+    }
+
+    void create_test_schema() {
+        std::string sql = R"(
+CREATE TABLE IF NOT EXISTS trips (
+    id INTEGER PRIMARY KEY,
+    route_id INTEGER NOT NULL,
+    start_time TEXT NOT NULL,
+    end_time TEXT NOT NULL
+);
+
+CREATE TABLE IF NOT EXISTS trip_stops (
+    trip_id INTEGER,
+    stop_id INTEGER,
+    arrival_time TEXT NOT NULL,
+    sequence INTEGER NOT NULL,
+    PRIMARY KEY (trip_id, stop_id)
+);
+)";
+
+        Database db;
+        if (db.connect(db_path)) {
+            db.execute(sql);
+            db.disconnect();
+        }
+    }
+
+    static TripSchedule schedule(int id, std::vector<int> stops, std::vector<std::string> times) {
+        TripSchedule result{Trip(id, 1, times.empty() ? "" : times.front(), times.empty() ? "" : times.back()),
+                            times};
+        result.trip.stop_sequence = std::move(stops);
+        return result;
+    }
+
+    TripService service;
+    std::string db_path;
+};
+
+TEST_F(TripServiceTest, CreateTripsWithStopTimes) {
+    std::vector<TripSchedule> schedules = {
+        schedule(10, {1, 3, 4}, {"08:00:00", "08:10:00", "08:20:00"}),
+        schedule(11, {4, 3}, {"09:00:00", "09:05:00"})
+    };
+    ASSERT_TRUE(service.create_trips_with_stop_times(schedules));
+
+    Trip trip = service.get_trip(10);
+    EXPECT_EQ(trip.start_time, "08:00:00");
+    EXPECT_EQ(trip.stop_sequence, (std::vector<int>{1, 3, 4}));
+    EXPECT_EQ(service.get_trip_stops(11), (std::vector<int>{4, 3}));
+}
+
+TEST_F(TripServiceTest, CreateTripsRollsBackOnFailure) {
+    ASSERT_TRUE(service.create_trips_with_stop_times({schedule(10, {1}, {"08:00:00"})}));
+
+    // El viaje 10 ya existe: el 12 tampoco se crea
+    EXPECT_FALSE(service.create_trips_with_stop_times({schedule(12, {1, 2}, {"10:00:00", "10:05:00"}),
+                                                       schedule(10, {5}, {"11:00:00"})}));
+    EXPECT_EQ(service.get_trip(12).id, 0);
+    EXPECT_TRUE(service.get_trip_stops(12).empty());
+
+    // Horas que no cuadran con las paradas
+    TripSchedule mismatched = schedule(13, {1, 2}, {"10:00:00"});
+    EXPECT_FALSE(service.create_trips_with_stop_times({mismatched}));
+    EXPECT_EQ(service.get_trip(13).id, 0);
+}
+
+TEST_F(TripServiceTest, AppendStopUsesNextSequence) {
+    ASSERT_TRUE(service.create_trips_with_stop_times({schedule(10, {1, 2}, {"08:00:00", "08:05:00"})}));
+    ASSERT_TRUE(service.add_stop_to_trip(10, 3, 0));
+    EXPECT_EQ(service.get_trip_stops(10), (std::vector<int>{1, 2, 3}));
+}
+
+TEST_F(TripServiceTest, CachedTripsFollowWrites) {
+    ASSERT_TRUE(service.create_trips_with_stop_times({schedule(10, {1, 3}, {"08:00:00", "08:10:00"})}));
+    EXPECT_EQ(service.get_all_trips().size(), 1u);
+
+    // Secuencia explícita en medio del viaje
+    ASSERT_TRUE(service.add_stop_to_trip(10, 4, 9));
+    ASSERT_TRUE(service.add_stop_to_trip(10, 2, 5));
+    EXPECT_EQ(service.get_trip_stops(10), (std::vector<int>{1, 3, 2, 4}));
+
+    Trip changed(10, 2, "08:30:00", "08:40:00");
+    ASSERT_TRUE(service.update_trip(changed));
+    Trip trip = service.get_trip(10);
+    EXPECT_EQ(trip.route_id, 2);
+    EXPECT_EQ(trip.start_time, "08:30:00");
+    EXPECT_EQ(trip.stop_sequence.size(), 4u);
+
+    ASSERT_TRUE(service.create_trip(Trip(11, 1, "09:00:00", "09:30:00")));
+    ASSERT_TRUE(service.delete_trip(10));
+    auto trips = service.get_all_trips();
+    ASSERT_EQ(trips.size(), 1u);
+    EXPECT_EQ(trips[0].id, 11);
+    EXPECT_EQ(service.cache_stats().misses, 1u);
+}
+
+TEST_F(TripServiceTest, FindTripsAssembleStopSequences) {
+    TripSchedule other = schedule(12, {5, 6}, {"07:00:00", "07:20:00"});
+    other.trip.route_id = 2;
+    ASSERT_TRUE(service.create_trips_with_stop_times({schedule(10, {1, 2, 3}, {"09:00:00", "09:05:00", "09:10:00"}),
+                                                      schedule(11, {3, 2, 1}, {"08:00:00", "08:05:00", "08:10:00"}),
+                                                      other}));
+    ASSERT_TRUE(service.create_trip(Trip(13, 1, "10:00:00", "10:00:00")));
+
+    auto by_route = service.find_trips_by_route(1);
+    ASSERT_EQ(by_route.size(), 3u);
+    EXPECT_EQ(by_route[0].stop_sequence, (std::vector<int>{1, 2, 3}));
+    EXPECT_EQ(by_route[1].stop_sequence, (std::vector<int>{3, 2, 1}));
+    EXPECT_TRUE(by_route[2].stop_sequence.empty());
+
+    auto in_range = service.find_trips_by_time_range("07:30:00", "09:30:00");
+    ASSERT_EQ(in_range.size(), 2u);
+    EXPECT_EQ(in_range[0].id, 11);
+    EXPECT_EQ(in_range[1].id, 10);
+    EXPECT_EQ(in_range[1].stop_sequence, (std::vector<int>{1, 2, 3}));
+}
+
+TEST_F(TripServiceTest, TimeWindowQueriesUseIntegerColumns) {
+    // Filas escritas sin las columnas en segundos: las rellena la migración
+    Database db;
+    ASSERT_TRUE(db.connect(db_path));
+    ASSERT_TRUE(db.execute("INSERT INTO trips (id, route_id, start_time, end_time) VALUES "
+                           "(1, 1, '8:00:00', '09:00:00'), (2, 1, '23:40:00', '24:30:00'), (3, 1, '', '')"));
+
+    auto in_range = service.find_trips_by_time_range("07:00:00", "10:00:00");
+    ASSERT_EQ(in_range.size(), 1u);
+    EXPECT_EQ(in_range[0].id, 1);
+    int migrated = 0;
+    db.query_rows("SELECT start_seconds FROM trips WHERE id = 1", [&](const RowView& row) {
+        migrated = row.get_int(0);
+        return false;
+    });
+    EXPECT_EQ(migrated, 8 * 3600);
+    db.disconnect();
+
+    // Pasada la medianoche circula el viaje del día de servicio anterior
+    auto after_midnight = service.find_trips_active_at("00:15:00");
+    ASSERT_EQ(after_midnight.size(), 1u);
+    EXPECT_EQ(after_midnight[0].id, 2);
+
+    ASSERT_TRUE(service.create_trip(Trip(4, 1, "08:30:00", "08:45:00")));
+    ASSERT_TRUE(service.update_trip(Trip(1, 1, "11:00:00", "12:00:00")));
+    auto active = service.find_trips_active_between("08:40:00", "11:30:00");
+    ASSERT_EQ(active.size(), 2u);
+    EXPECT_EQ(active[0].id, 4);
+    EXPECT_EQ(active[1].id, 1);
+
+    ASSERT_TRUE(service.delete_trip(4));
+    EXPECT_TRUE(service.find_trips_active_at("08:40:00").empty());
+    EXPECT_TRUE(service.find_trips_by_time_range("08:00:00", "nope").empty());
+}
+
+TEST_F(TripServiceTest, DepartureBoardFollowsTripChanges) {
+    TripSchedule other = schedule(12, {2, 5}, {"08:05:00", "08:20:00"});
+    other.trip.route_id = 2;
+    ASSERT_TRUE(service.create_trips_with_stop_times({schedule(10, {1, 2}, {"08:00:00", "08:10:00"}),
+                                                      schedule(11, {1, 2}, {"08:30:00", "08:40:00"}),
+                                                      other}));
+
+    auto next = service.next_departures(2, "08:00:00", 2);
+    ASSERT_EQ(next.size(), 2u);
+    EXPECT_EQ(next[0].trip_id, 12);
+    EXPECT_EQ(next[0].route_id, 2);
+    EXPECT_EQ(format_service_time(next[1].time), "08:10:00");
+
+    // Altas posteriores a la carga del panel
+    ASSERT_TRUE(service.create_trip(Trip(13, 2, "08:02:00", "08:02:00")));
+    ASSERT_TRUE(service.add_stop_to_trip(13, 2, 0, "08:02:00"));
+    ASSERT_TRUE(service.add_stop_to_trip(10, 3, 0));
+    next = service.next_departures(2, "08:00:00", 1);
+    ASSERT_EQ(next.size(), 1u);
+    EXPECT_EQ(next[0].trip_id, 13);
+    EXPECT_TRUE(service.next_departures(3, "00:00:00", 5).empty());
+
+    auto groups = service.next_departures_by_route(2, "08:00:00", "09:00:00", 1);
+    ASSERT_EQ(groups.size(), 2u);
+    EXPECT_EQ(groups[0].route_id, 2);
+    EXPECT_EQ(groups[0].departures[0].trip_id, 13);
+    EXPECT_EQ(groups[1].route_id, 1);
+    EXPECT_EQ(groups[1].departures[0].trip_id, 10);
+
+    ASSERT_TRUE(service.delete_trip(13));
+    ASSERT_TRUE(service.update_trip(Trip(10, 3, "08:00:00", "08:10:00")));
+    next = service.next_departures(2, "08:00:00", 2);
+    ASSERT_EQ(next.size(), 2u);
+    EXPECT_EQ(next[0].trip_id, 12);
+    EXPECT_EQ(next[1].route_id, 3);
+}